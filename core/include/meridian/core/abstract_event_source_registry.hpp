@@ -0,0 +1,135 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__core__abstract_event_source_registry__hpp
+#define meridian__core__abstract_event_source_registry__hpp
+
+#include "meridian/core/event_source.hpp"
+
+namespace meridian {
+namespace core {
+
+//! \brief The interface through which a reactor registers callbacks on \ref event_source "event_source"s and finds
+//! them by file descriptor.
+//! \class abstract_event_source_registry abstract_event_source_registry.hpp meridian/core/abstract_event_source_registry.hpp
+//!
+//! Every reactor holds its registry through this interface, so that it may be given any implementation through its
+//! constructor: event_source_registry, which keeps \ref event_source "event_source"s in an intrusive hashtable, or
+//! dense_event_source_registry, which keeps them in an array indexed by file descriptor.
+//!
+//! \author Eric Crampton
+
+class abstract_event_source_registry {
+public:
+    //! \brief Destruction.
+
+    virtual ~abstract_event_source_registry();
+
+    abstract_event_source_registry(abstract_event_source_registry const & registry) = delete;
+    abstract_event_source_registry & operator=(abstract_event_source_registry const & registry) = delete;
+
+    //! \brief Registers a readable callback for an event_source.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param callback - callback to be called for readable events
+    //!
+    //! If a readable callback is already registered for the given \a source, it is overwritten with the new callback.
+
+    virtual void register_read_callback(event_source & source, event_source::event_callback callback) = 0;
+
+    //! \brief Registers a writable callback for an event_source.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param callback - callback to be called for writable events
+    //!
+    //! If a writable callback is already registered for the given \a source, it is overwritten with the new callback.
+
+    virtual void register_write_callback(event_source & source, event_source::event_callback callback) = 0;
+
+    //! \brief Registers an exception callback for an event_source.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param callback - callback to be called for exception events
+    //!
+    //! If an exception callback is already registered for the given \a source, it is overwritten with the new callback.
+
+    virtual void register_except_callback(event_source & source, event_source::event_callback callback) = 0;
+
+    //! \brief Removes the readable callback for an event_source, if any.
+    //!
+    //! \param source - the event_source whose readable callback is to be removed.
+    //!
+    //! If no callback is associated, this does nothing.
+
+    virtual void remove_read_callback(event_source & source) = 0;
+
+    //! \brief Removes the writable callback for an event_source, if any.
+    //!
+    //! \param source - the event_source whose writable callback is to be removed.
+    //!
+    //! If no callback is associated, this does nothing.
+
+    virtual void remove_write_callback(event_source & source) = 0;
+
+    //! \brief Removes the exception callback for an event_source, if any.
+    //!
+    //! \param source - the event_source whose exception callback is to be removed.
+    //!
+    //! If no callback is associated, this does nothing.
+
+    virtual void remove_except_callback(event_source & source) = 0;
+
+    //! \brief Registers a unified handler for an event_source.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param handler - handler to be called with the ready events
+    //! \param interest - the events to monitor
+    //!
+    //! If a handler is already registered for the given \a source, it is overwritten with the new handler. No
+    //! per-event callbacks may be registered for \a source.
+
+    virtual void register_handler(
+            event_source & source,
+            event_source::event_handler handler,
+            event_source::event_mask interest) = 0;
+
+    //! \brief Changes the interest set of an event_source's unified handler.
+    //!
+    //! \param source - an event_source with a registered handler
+    //! \param interest - the events to monitor
+    //!
+    //! The interest set is kept in the event_source itself, so this is the same for every registry.
+
+    void set_interest(event_source & source, event_source::event_mask interest);
+
+    //! \brief Removes the unified handler for an event_source, if any.
+    //!
+    //! \param source - the event_source
+
+    virtual void remove_handler(event_source & source) = 0;
+
+    //! \brief Finds the event_source registered for a file descriptor.
+    //!
+    //! \param fd - OS file descriptor
+    //!
+    //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
+
+    virtual event_source * find(int fd) = 0;
+
+    //! \brief Finds the event_source registered for a file descriptor.
+    //!
+    //! \param fd - OS file descriptor
+    //!
+    //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
+
+    virtual event_source const * find(int fd) const = 0;
+
+protected:
+    abstract_event_source_registry() = default;
+};
+
+} // namespace meridian
+} // namespace core
+
+#endif /* meridian__core__abstract_event_source_registry__hpp */
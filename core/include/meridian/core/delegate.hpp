@@ -0,0 +1,162 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__core__delegate__hpp
+#define meridian__core__delegate__hpp
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace meridian {
+namespace core {
+
+template <typename SIGNATURE>
+class delegate;
+
+//! \brief A move-only callable wrapper with inline storage.
+//! \class delegate delegate.hpp meridian/core/delegate.hpp
+//!
+//! A delegate fills the role of \c std::function for callbacks which are stored once and invoked many times, such as
+//! the callbacks held by an event_source. It differs in three ways:
+//!
+//! - A callable of up to INLINE_SIZE bytes (a \c this pointer plus two more words---enough for a lambda capturing a
+//!   few references, or a \c std::bind of a member function to an object) is stored inline and never allocates.
+//!   Larger callables fall back to the heap, so the cost is paid once, at construction.
+//! - A delegate can't be copied, only moved, so a callable is never duplicated behind the caller's back.
+//! - Invocation is a single indirect call on the stored callable, in place. invoke_detached() is for callers, such
+//!   as reactors, whose callable may destroy or reassign the delegate it is stored in.
+//!
+//! \author Eric Crampton
+
+template <typename R, typename... ARGS>
+class delegate<R (ARGS...)> {
+    typedef typename std::aligned_storage<3 * sizeof(void *), alignof(void *)>::type storage_type;
+
+public:
+    //! \brief The number of bytes of callable which is stored without allocating.
+
+    static size_t const INLINE_SIZE = sizeof(storage_type);
+
+    //! \brief True if a callable of type \a FUNCTION is stored inline.
+
+    template <typename FUNCTION>
+    struct is_inline : std::integral_constant<
+        bool,
+        sizeof(FUNCTION) <= sizeof(storage_type)
+            && alignof(FUNCTION) <= alignof(storage_type)
+            && std::is_nothrow_move_constructible<FUNCTION>::value> {
+    };
+
+    //! \brief Constructs an empty delegate.
+
+    inline delegate() noexcept;
+
+    //! \brief Constructs an empty delegate.
+
+    inline delegate(std::nullptr_t) noexcept;
+
+    //! \brief Constructs a delegate which calls \a function.
+    //!
+    //! \param function - any callable object invocable with \a ARGS
+
+    template <
+        typename FUNCTION,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<FUNCTION>::type, delegate>::value>::type>
+    delegate(FUNCTION && function);
+
+    //! \brief Move construction; \a other is left empty.
+
+    inline delegate(delegate && other) noexcept;
+
+    //! \brief Move assignment; \a other is left empty.
+
+    inline delegate & operator=(delegate && other) noexcept;
+
+    //! \brief Empties this delegate, destroying the stored callable.
+
+    inline delegate & operator=(std::nullptr_t) noexcept;
+
+    //! \brief Copy construction is \a not permitted.
+
+    delegate(delegate const & other) = delete;
+
+    //! \brief Copy assignment is \a not permitted.
+
+    delegate & operator=(delegate const & other) = delete;
+
+    //! \brief Destruction.
+
+    inline ~delegate();
+
+    //! \brief Returns true if this delegate holds a callable.
+
+    inline explicit operator bool() const noexcept;
+
+    //! \brief Calls the stored callable in place.
+    //!
+    //! The delegate must not be empty, and the callable must not cause this delegate to be destroyed or reassigned;
+    //! use invoke_detached() if it might.
+
+    inline R operator()(ARGS... args) const;
+
+    //! \brief Calls the stored callable from the caller's stack frame, so that it may destroy or reassign this delegate.
+    //!
+    //! The delegate must not be empty. The callable is moved out for the duration of the call, leaving a stand-in
+    //! which still tests true, so a callback can tell that its own registration is in place (e.g., a reactor callback
+    //! which removes its own registration, or destroys the event_source holding it). If the stand-in is neither
+    //! destroyed nor reassigned by the time the call returns, the callable is moved back. Neither move allocates.
+
+    inline R invoke_detached(ARGS... args);
+
+private:
+    enum class operation {
+        move,
+        destroy
+    };
+
+    struct detached_call;
+    class stand_in;
+
+    typedef R (*invoker)(void * storage, ARGS... args);
+    typedef void (*manager)(operation op, void * target, void * source);
+
+    template <typename FUNCTION>
+    void store(FUNCTION && function, std::true_type);
+
+    template <typename FUNCTION>
+    void store(FUNCTION && function, std::false_type);
+
+    inline void move_from(delegate & other) noexcept;
+
+    template <typename FUNCTION>
+    static R invoke_inline(void * storage, ARGS... args);
+
+    template <typename FUNCTION>
+    static R invoke_heap(void * storage, ARGS... args);
+
+    template <typename FUNCTION>
+    static void manage_inline(operation op, void * target, void * source);
+
+    template <typename FUNCTION>
+    static void manage_heap(operation op, void * target, void * source);
+
+private:
+    mutable storage_type storage_;
+    invoker invoke_;
+
+    //! \brief Moves or destroys the stored callable; \c nullptr when that is a plain byte copy and a no-op.
+    manager manage_;
+};
+
+#include "meridian/core/delegate.ipp"
+
+} // namespace core
+} // namespace meridian
+
+#endif /* meridian__core__delegate__hpp */
@@ -0,0 +1,252 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename R, typename... ARGS>
+size_t const delegate<R (ARGS...)>::INLINE_SIZE;
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)>::delegate() noexcept
+    : invoke_(nullptr)
+    , manage_(nullptr)
+{
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)>::delegate(std::nullptr_t) noexcept
+    : invoke_(nullptr)
+    , manage_(nullptr)
+{
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION, typename>
+delegate<R (ARGS...)>::delegate(FUNCTION && function)
+    : invoke_(nullptr)
+    , manage_(nullptr)
+{
+    typedef typename std::decay<FUNCTION>::type function_type;
+    store(std::forward<FUNCTION>(function), is_inline<function_type>());
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)>::delegate(delegate && other) noexcept
+    : invoke_(nullptr)
+    , manage_(nullptr)
+{
+    move_from(other);
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)> & delegate<R (ARGS...)>::operator=(delegate && other) noexcept
+{
+    if (this != &other) {
+        *this = nullptr;
+        move_from(other);
+    }
+
+    return *this;
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)> & delegate<R (ARGS...)>::operator=(std::nullptr_t) noexcept
+{
+    if (manage_) {
+        manage_(operation::destroy, &storage_, nullptr);
+    }
+
+    invoke_ = nullptr;
+    manage_ = nullptr;
+
+    return *this;
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)>::~delegate()
+{
+    if (manage_) {
+        manage_(operation::destroy, &storage_, nullptr);
+    }
+}
+
+
+template <typename R, typename... ARGS>
+delegate<R (ARGS...)>::operator bool() const noexcept
+{
+    return invoke_ != nullptr;
+}
+
+
+template <typename R, typename... ARGS>
+R delegate<R (ARGS...)>::operator()(ARGS... args) const
+{
+    assert(invoke_);
+    return invoke_(&storage_, std::forward<ARGS>(args)...);
+}
+
+
+//! \brief The callable moved out by invoke_detached(), and the delegate to return it to.
+
+template <typename R, typename... ARGS>
+struct delegate<R (ARGS...)>::detached_call {
+    detached_call(delegate && function, delegate * owner) noexcept
+        : callable(std::move(function))
+        , home(owner)
+    {
+    }
+
+    ~detached_call()
+    {
+        if (home) {
+            *home = std::move(callable);
+        }
+    }
+
+    delegate callable;
+
+    //! \brief The delegate holding the stand-in, or \c nullptr once the stand-in has been destroyed.
+    delegate * home;
+};
+
+
+//! \brief What invoke_detached() leaves behind; destroying it cancels the return of the callable.
+
+template <typename R, typename... ARGS>
+class delegate<R (ARGS...)>::stand_in {
+public:
+    explicit stand_in(detached_call * call) noexcept
+        : call_(call)
+    {
+    }
+
+    stand_in(stand_in && other) noexcept
+        : call_(other.call_)
+    {
+        other.call_ = nullptr;
+    }
+
+    ~stand_in()
+    {
+        if (call_) {
+            call_->home = nullptr;
+        }
+    }
+
+    R operator()(ARGS... args) const
+    {
+        return call_->callable(std::forward<ARGS>(args)...);
+    }
+
+private:
+    detached_call * call_;
+};
+
+
+template <typename R, typename... ARGS>
+R delegate<R (ARGS...)>::invoke_detached(ARGS... args)
+{
+    assert(invoke_);
+
+    // call outlives everything the callable might do to *this; its destructor moves the callable back, unless the
+    // stand-in is gone by then.
+    detached_call call(std::move(*this), this);
+    *this = stand_in(&call);
+    return call.callable(std::forward<ARGS>(args)...);
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+void delegate<R (ARGS...)>::store(FUNCTION && function, std::true_type)
+{
+    typedef typename std::decay<FUNCTION>::type function_type;
+
+    new (&storage_) function_type(std::forward<FUNCTION>(function));
+    invoke_ = &invoke_inline<function_type>;
+    manage_ = std::is_trivially_copyable<function_type>::value ? nullptr : &manage_inline<function_type>;
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+void delegate<R (ARGS...)>::store(FUNCTION && function, std::false_type)
+{
+    typedef typename std::decay<FUNCTION>::type function_type;
+
+    *reinterpret_cast<function_type **>(&storage_) = new function_type(std::forward<FUNCTION>(function));
+    invoke_ = &invoke_heap<function_type>;
+    manage_ = &manage_heap<function_type>;
+}
+
+
+template <typename R, typename... ARGS>
+void delegate<R (ARGS...)>::move_from(delegate & other) noexcept
+{
+    if (other.manage_) {
+        other.manage_(operation::move, &storage_, &other.storage_);
+    }
+    else {
+        std::memcpy(&storage_, &other.storage_, sizeof(storage_));
+    }
+
+    invoke_ = other.invoke_;
+    manage_ = other.manage_;
+    other.invoke_ = nullptr;
+    other.manage_ = nullptr;
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+R delegate<R (ARGS...)>::invoke_inline(void * storage, ARGS... args)
+{
+    return (*static_cast<FUNCTION *>(storage))(std::forward<ARGS>(args)...);
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+R delegate<R (ARGS...)>::invoke_heap(void * storage, ARGS... args)
+{
+    return (**static_cast<FUNCTION **>(storage))(std::forward<ARGS>(args)...);
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+void delegate<R (ARGS...)>::manage_inline(operation op, void * target, void * source)
+{
+    switch (op) {
+        case operation::move:
+            new (target) FUNCTION(std::move(*static_cast<FUNCTION *>(source)));
+            static_cast<FUNCTION *>(source)->~FUNCTION();
+            break;
+
+        case operation::destroy:
+            static_cast<FUNCTION *>(target)->~FUNCTION();
+            break;
+    }
+}
+
+
+template <typename R, typename... ARGS>
+template <typename FUNCTION>
+void delegate<R (ARGS...)>::manage_heap(operation op, void * target, void * source)
+{
+    switch (op) {
+        case operation::move:
+            *static_cast<FUNCTION **>(target) = *static_cast<FUNCTION **>(source);
+            break;
+
+        case operation::destroy:
+            delete *static_cast<FUNCTION **>(target);
+            break;
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__core__dense_event_source_registry__hpp
+#define meridian__core__dense_event_source_registry__hpp
+
+#include "meridian/core/abstract_event_source_registry.hpp"
+
+#include <vector>
+
+namespace meridian {
+namespace core {
+
+//! \brief An abstract_event_source_registry backed by an array indexed by file descriptor.
+//! \class dense_event_source_registry dense_event_source_registry.hpp meridian/core/dense_event_source_registry.hpp
+//!
+//! OS file descriptors are small integers which the kernel allocates lowest-first, so a flat array of pointers indexed
+//! by file descriptor gives an O(1) find() with a single bounds check and a single load, with no hashing and no
+//! bucket chain to walk on every dispatched event. The array is grown on demand when a file descriptor beyond its end
+//! is registered; it is never shrunk.
+//!
+//! A dense_event_source_registry can be handed to any reactor through its
+//! <tt>std::unique_ptr<core::abstract_event_source_registry></tt> constructor.
+//!
+//! \author Eric Crampton
+
+class dense_event_source_registry : public abstract_event_source_registry {
+public:
+    //! \brief Construction.
+    //!
+    //! \param capacity - the number of file descriptors to reserve slots for up front
+
+    explicit dense_event_source_registry(size_t capacity = 1024);
+
+    //! \brief Registers a readable callback for an event_source.
+
+    void register_read_callback(event_source & source, event_source::event_callback callback) override;
+
+    //! \brief Registers a writable callback for an event_source.
+
+    void register_write_callback(event_source & source, event_source::event_callback callback) override;
+
+    //! \brief Registers an exception callback for an event_source.
+
+    void register_except_callback(event_source & source, event_source::event_callback callback) override;
+
+    //! \brief Removes the readable callback for an event_source, if any.
+
+    void remove_read_callback(event_source & source) override;
+
+    //! \brief Removes the writable callback for an event_source, if any.
+
+    void remove_write_callback(event_source & source) override;
+
+    //! \brief Removes the exception callback for an event_source, if any.
+
+    void remove_except_callback(event_source & source) override;
+
+    //! \brief Registers a unified handler for an event_source.
+
+    void register_handler(
+            event_source & source,
+            event_source::event_handler handler,
+            event_source::event_mask interest) override;
+
+    //! \brief Removes the unified handler for an event_source, if any.
+
+    void remove_handler(event_source & source) override;
+
+    //! \brief Finds the event_source registered for a file descriptor.
+    //!
+    //! \param fd - the OS file descriptor
+    //!
+    //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
+
+    event_source * find(int fd) override;
+
+    //! \brief Finds the event_source registered for a file descriptor.
+    //!
+    //! \param fd - the OS file descriptor
+    //!
+    //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
+
+    event_source const * find(int fd) const override;
+
+    //! \brief Returns the number of file descriptor slots currently allocated.
+
+    inline size_t capacity() const;
+
+private:
+    //! \brief Associates \a source with its file descriptor's slot, growing the array if needed.
+
+    void insert(event_source & source);
+
+    //! \brief Clears the slot for \a source if it no longer has any callbacks.
+
+    inline void erase_source_without_callback(event_source & source);
+
+private:
+    std::vector<event_source *> sources_;
+};
+
+#include "meridian/core/dense_event_source_registry.ipp"
+
+} // namespace meridian
+} // namespace core
+
+#endif /* meridian__core__dense_event_source_registry__hpp */
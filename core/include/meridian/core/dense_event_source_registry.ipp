@@ -0,0 +1,16 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+size_t dense_event_source_registry::capacity() const
+{
+    return sources_.size();
+}
+
+
+void dense_event_source_registry::erase_source_without_callback(event_source & source)
+{
+    if (!source.has_callback()) {
+        sources_[source.fd()] = nullptr;
+    }
+}
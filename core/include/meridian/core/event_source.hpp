@@ -5,9 +5,12 @@
 #ifndef meridian__core__event_source__hpp
 #define meridian__core__event_source__hpp
 
+#include "meridian/core/delegate.hpp"
+
 #include <boost/intrusive/unordered_set.hpp>
 #include <boost/intrusive/unordered_set_hook.hpp>
-#include <functional>
+#include <cstdint>
+#include <memory>
 
 namespace meridian {
 namespace core {
@@ -30,6 +33,13 @@ event_source_base_hook;
 //! such as the meridian::reactor::select_reactor. Often, a reactor will have work to be done each time an event_source
 //! callback is registered, so registration must be done via functions on that reactor.
 //!
+//! <b>Layout.</b> A server may hold millions of mostly idle event_sources, so the object is kept to a single 64-byte
+//! cache line on LP64 platforms (see SIZE_BUDGET). Everything a reactor touches when dispatching (the hashtable hook,
+//! the file descriptor, the interest set, and one callable) is stored inline. The callable slot holds either the
+//! unified handler or the first per-event callback registered, which covers both a handler-style source and the common
+//! source with a single readable callback. Any further per-event callbacks live in a separately allocated block,
+//! created the first time one of them doesn't fit in the slot and kept until the event_source is destroyed.
+//!
 //! \author Eric Crampton
 
 class event_source : public event_source_base_hook {
@@ -43,6 +53,10 @@ protected:
     
     event_source(int fd);
 
+    //! \brief Destruction.
+
+    ~event_source();
+
     //! \brief Reset the OS file descriptor associated with this event_source.
     //!
     //! \param fd - the new OS file descriptor
@@ -57,31 +71,107 @@ public:
     //! Note that this function takes no parameters and returns @c void. If you would like to have data associated with
     //! a callback at registration time, the recommended method is to use @c std::bind to pass the data. There are
     //! numerous examples distributed with Meridian which show this.
+    //!
+    //! The callback is a move-only delegate: a lambda capturing a few references, or a @c std::bind of a member
+    //! function to @c this, is stored without allocating. Reactors call it with invoke_read_callback() and friends, so
+    //! it may remove or replace its own registration, or destroy its event_source.
     
-    typedef std::function<void ()> event_callback;
+    typedef delegate<void ()> event_callback;
+
+    //! \brief A set of events, made of READABLE, WRITABLE, and EXCEPTION bits.
+
+    typedef std::uint8_t event_mask;
+
+    static event_mask const READABLE  = 1 << 0; //!< the readable event
+    static event_mask const WRITABLE  = 1 << 1; //!< the writable event
+    static event_mask const EXCEPTION = 1 << 2; //!< the exception event
+
+    //! \brief Unified handler function type.
+    //!
+    //! As an alternative to separate readable, writable, and exception callbacks, a single handler may be registered
+    //! for an event_source. It's called at most once per wakeup with every event which is both ready and in the
+    //! event_source's interest set, so a full-duplex connection costs one stored callable and one call per wakeup.
+    //! A handler and per-event callbacks can't be registered on the same event_source at the same time.
+
+    typedef delegate<void (event_mask)> event_handler;
+
+    //! \brief The size, in bytes, which an event_source is not allowed to grow beyond on LP64 platforms.
+    //!
+    //! This includes the inline slot for the unified handler or the first per-event callback, but not the block
+    //! allocated for any further per-event callbacks.
+
+    static size_t const SIZE_BUDGET = 64;
 
     //! \brief Return the callback for the readable event, if any.
     //!
     //! \return the callback, or an empty function if no callback is associated
     
-    inline event_callback read_callback() const;
+    inline event_callback const & read_callback() const;
 
     //! \brief Return the callback for the writable event, if any.
     //!
     //! \return the callback, or an empty function if no callback is associated
 
-    inline event_callback write_callback() const;
+    inline event_callback const & write_callback() const;
 
     //! \brief Return the callback for the exception event, if any.
     //!
     //! \return the callback, or an empty function if no callback is associated
 
-    inline event_callback except_callback() const;
+    inline event_callback const & except_callback() const;
 
-    //! \brief Returns true if this event_source has any registered callbacks.
+    //! \brief Return the unified handler, if any.
+    //!
+    //! \return the handler, or an empty delegate if no handler is registered
+
+    inline event_handler const & handler() const;
+
+    //! \brief Calls the readable callback, which must be registered.
+    //!
+    //! The callback is called with delegate::invoke_detached(), so it may remove or replace its own registration, or
+    //! destroy this event_source.
+
+    inline void invoke_read_callback();
+
+    //! \brief Calls the writable callback, which must be registered; see invoke_read_callback().
+
+    inline void invoke_write_callback();
+
+    //! \brief Calls the exception callback, which must be registered; see invoke_read_callback().
+
+    inline void invoke_except_callback();
+
+    //! \brief Calls the unified handler, which must be registered, with the \a ready events; see
+    //! invoke_read_callback().
+
+    inline void invoke_handler(event_mask ready);
+
+    //! \brief Returns true if this event_source has any registered callbacks, including a unified handler.
 
     inline bool has_callback() const;
 
+    //! \brief Returns true if a readable callback is registered.
+
+    inline bool has_read_callback() const;
+
+    //! \brief Returns true if a writable callback is registered.
+
+    inline bool has_write_callback() const;
+
+    //! \brief Returns true if an exception callback is registered.
+
+    inline bool has_except_callback() const;
+
+    //! \brief Returns true if a unified handler is registered.
+
+    inline bool has_handler() const;
+
+    //! \brief Returns the events this event_source should be monitored for.
+    //!
+    //! With a unified handler, this is its interest set; otherwise it has a bit for each registered callback.
+
+    inline event_mask interest() const;
+
     //! \brief Returns the OS file descriptor for this event_source.
     
     inline int fd() const;
@@ -105,7 +195,9 @@ public:
     };
 
 private:
+    friend class abstract_event_source_registry;
     friend class event_source_registry;
+    friend class dense_event_source_registry;
 
     //! \brief Sets the readable callback for this event_source.
     //!
@@ -148,12 +240,81 @@ private:
     //! This is more readable than calling set_except_callback with an empty function.
 
     inline void remove_except_callback();
-    
+
+    //! \brief Sets the unified handler and its interest set for this event_source.
+    //!
+    //! \param handler - the handler
+    //! \param interest - the events to monitor
+    //!
+    //! Overwrites any previously set handler. No per-event callbacks may be set.
+
+    inline void set_handler(event_handler handler, event_mask interest);
+
+    //! \brief Changes the interest set of the unified handler.
+
+    inline void set_interest(event_mask interest);
+
+    //! \brief Removes the unified handler for this event_source.
+
+    inline void remove_handler();
+
+    //! \brief What the inline slot holds: nothing, the unified handler, or the callback for one event.
+
+    enum class slot_content : std::uint8_t {
+        empty,
+        handler,
+        read,
+        write,
+        except
+    };
+
+    //! \brief The out-of-line storage for the per-event callbacks which don't fit in the inline slot.
+
+    struct callback_set {
+        event_callback read;
+        event_callback write;
+        event_callback except;
+    };
+
+    //! \brief Returns the per-event callback for \a content, or an empty callback if none is registered.
+
+    inline event_callback const & callback(slot_content content, event_callback callback_set::* member) const;
+
+    //! \brief Calls the per-event callback for \a content, which must be registered.
+
+    inline void invoke_callback(slot_content content, event_callback callback_set::* member);
+
+    //! \brief Sets the per-event callback for \a content, in the inline slot if it's free.
+
+    inline void set_callback(slot_content content, event_callback callback_set::* member, event_callback callback);
+
+    //! \brief Removes the per-event callback for \a content, if any.
+
+    inline void remove_callback(slot_content content, event_callback callback_set::* member);
+
+    //! \brief Destroys the contents of the inline slot, leaving it empty.
+
+    inline void clear_slot();
+
+    //! \brief An empty callback, returned by the accessors when no callback is registered.
+
+    static event_callback const NO_CALLBACK;
+
+    //! \brief An empty handler, returned by handler() when no handler is registered.
+
+    static event_handler const NO_HANDLER;
+
 private:
     int fd_;
-    event_callback read_callback_;
-    event_callback write_callback_;
-    event_callback except_callback_;
+    event_mask handler_interest_;
+    slot_content slot_;
+
+    union {
+        event_handler handler_;
+        event_callback callback_;
+    };
+
+    std::unique_ptr<callback_set> callbacks_;
 };
 
 //! \brief An intrusive hashtable mapping file descriptors to \ref event_source "event_source"s.
@@ -10,63 +10,248 @@ void event_source::reset_fd(int fd)
 }
 
 
-event_source::event_callback event_source::read_callback() const
+event_source::event_callback const & event_source::read_callback() const
 {
-    return read_callback_;
+    return callback(slot_content::read, &callback_set::read);
 }
 
 
-event_source::event_callback event_source::write_callback() const
+event_source::event_callback const & event_source::write_callback() const
 {
-    return write_callback_;
+    return callback(slot_content::write, &callback_set::write);
 }
 
 
-event_source::event_callback event_source::except_callback() const
+event_source::event_callback const & event_source::except_callback() const
 {
-    return except_callback_;
+    return callback(slot_content::except, &callback_set::except);
+}
+
+
+event_source::event_handler const & event_source::handler() const
+{
+    return slot_ == slot_content::handler ? handler_ : NO_HANDLER;
+}
+
+
+void event_source::invoke_read_callback()
+{
+    invoke_callback(slot_content::read, &callback_set::read);
+}
+
+
+void event_source::invoke_write_callback()
+{
+    invoke_callback(slot_content::write, &callback_set::write);
+}
+
+
+void event_source::invoke_except_callback()
+{
+    invoke_callback(slot_content::except, &callback_set::except);
+}
+
+
+void event_source::invoke_handler(event_mask ready)
+{
+    assert(slot_ == slot_content::handler);
+    handler_.invoke_detached(ready);
 }
 
 
 bool event_source::has_callback() const
 {
-    return read_callback_ || write_callback_ || except_callback_;
+    return slot_ != slot_content::empty
+        || (callbacks_ && (callbacks_->read || callbacks_->write || callbacks_->except));
+}
+
+
+bool event_source::has_read_callback() const
+{
+    return static_cast<bool>(read_callback());
+}
+
+
+bool event_source::has_write_callback() const
+{
+    return static_cast<bool>(write_callback());
+}
+
+
+bool event_source::has_except_callback() const
+{
+    return static_cast<bool>(except_callback());
+}
+
+
+bool event_source::has_handler() const
+{
+    return slot_ == slot_content::handler;
+}
+
+
+event_source::event_mask event_source::interest() const
+{
+    if (slot_ == slot_content::handler) {
+        return handler_interest_;
+    }
+
+    return (has_read_callback()   ? READABLE  : 0)
+         | (has_write_callback()  ? WRITABLE  : 0)
+         | (has_except_callback() ? EXCEPTION : 0);
 }
 
 
 void event_source::set_read_callback(event_callback callback)
 {
-    read_callback_ = callback;
+    set_callback(slot_content::read, &callback_set::read, std::move(callback));
 }
 
 
 void event_source::set_write_callback(event_callback callback)
 {
-    write_callback_ = callback;
+    set_callback(slot_content::write, &callback_set::write, std::move(callback));
 }
 
 
 void event_source::set_except_callback(event_callback callback)
 {
-    except_callback_ = callback;
+    set_callback(slot_content::except, &callback_set::except, std::move(callback));
 }
 
 
 void event_source::remove_read_callback()
 {
-    read_callback_ = 0;
+    remove_callback(slot_content::read, &callback_set::read);
 }
 
 
 void event_source::remove_write_callback()
 {
-    write_callback_ = 0;
+    remove_callback(slot_content::write, &callback_set::write);
 }
 
 
 void event_source::remove_except_callback()
 {
-    except_callback_ = 0;
+    remove_callback(slot_content::except, &callback_set::except);
+}
+
+
+void event_source::set_handler(event_handler handler, event_mask interest)
+{
+    assert(slot_ == slot_content::handler || !has_callback());
+
+    if (slot_ == slot_content::handler) {
+        handler_ = std::move(handler);
+    }
+    else if (handler) {
+        new (&handler_) event_handler(std::move(handler));
+        slot_ = slot_content::handler;
+    }
+
+    handler_interest_ = interest;
+}
+
+
+void event_source::set_interest(event_mask interest)
+{
+    assert(slot_ == slot_content::handler);
+    handler_interest_ = interest;
+}
+
+
+void event_source::remove_handler()
+{
+    if (slot_ == slot_content::handler) {
+        clear_slot();
+    }
+
+    handler_interest_ = 0;
+}
+
+
+event_source::event_callback const & event_source::callback(
+        slot_content content,
+        event_callback callback_set::* member) const
+{
+    if (slot_ == content) {
+        return callback_;
+    }
+
+    return callbacks_ ? (*callbacks_).*member : NO_CALLBACK;
+}
+
+
+void event_source::invoke_callback(slot_content content, event_callback callback_set::* member)
+{
+    if (slot_ == content) {
+        callback_.invoke_detached();
+    }
+    else {
+        assert(callbacks_);
+        ((*callbacks_).*member).invoke_detached();
+    }
+}
+
+
+void event_source::set_callback(
+        slot_content content,
+        event_callback callback_set::* member,
+        event_callback callback)
+{
+    assert(slot_ != slot_content::handler);
+
+    if (!callback) {
+        remove_callback(content, member);
+        return;
+    }
+
+    if (slot_ == content) {
+        callback_ = std::move(callback);
+        return;
+    }
+
+    if (slot_ == slot_content::empty) {
+        new (&callback_) event_callback(std::move(callback));
+        slot_ = content;
+        if (callbacks_) {
+            (*callbacks_).*member = nullptr;
+        }
+        return;
+    }
+
+    if (!callbacks_) {
+        callbacks_.reset(new callback_set);
+    }
+
+    (*callbacks_).*member = std::move(callback);
+}
+
+
+void event_source::remove_callback(slot_content content, event_callback callback_set::* member)
+{
+    if (slot_ == content) {
+        clear_slot();
+    }
+    else if (callbacks_) {
+        (*callbacks_).*member = nullptr;
+    }
+}
+
+
+void event_source::clear_slot()
+{
+    // The slot is marked empty first: destroying a callback which is being invoked may reenter this event_source.
+    slot_content const content = slot_;
+    slot_ = slot_content::empty;
+
+    if (content == slot_content::handler) {
+        handler_.~event_handler();
+    }
+    else if (content != slot_content::empty) {
+        callback_.~event_callback();
+    }
 }
 
 
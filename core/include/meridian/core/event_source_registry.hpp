@@ -5,7 +5,7 @@
 #ifndef meridian__core__event_source_registry__hpp
 #define meridian__core__event_source_registry__hpp
 
-#include "meridian/core/event_source.hpp"
+#include "meridian/core/abstract_event_source_registry.hpp"
 
 #include <memory>
 
@@ -21,9 +21,12 @@ namespace core {
 //! Internally, it's no secret, the registry uses an intrusive hashtable to manage the association between an OS file
 //! descriptor and an event_source.
 //!
+//! It's one of the implementations of abstract_event_source_registry, and the one every reactor uses unless given
+//! another (see dense_event_source_registry) through its constructor. Iteration is specific to the hashtable.
+//!
 //! \author Eric Crampton
 
-class event_source_registry {
+class event_source_registry : public abstract_event_source_registry {
 public:
     //! \brief Construction and initialization of the hashtable.
     //!
@@ -39,6 +42,10 @@ public:
     
     event_source_registry(event_source_registry && registry);
 
+    //! \brief Destruction.
+
+    ~event_source_registry();
+
     //! \brief Copy construction is \a not permitted.
 
     event_source_registry(event_source_registry const & registry) = delete;
@@ -54,7 +61,7 @@ public:
     //!
     //! If a readable callback is already registered for the given \a source, it is overwritten with the new callback.
 
-    void register_read_callback(event_source & source, event_source::event_callback callback);
+    void register_read_callback(event_source & source, event_source::event_callback callback) override;
 
     //! \brief Registers a writable callback for an event_source.
     //!
@@ -63,7 +70,7 @@ public:
     //!
     //! If a writable callback is already registered for the given \a source, it is overwritten with the new callback.
 
-    void register_write_callback(event_source & source, event_source::event_callback callback);
+    void register_write_callback(event_source & source, event_source::event_callback callback) override;
 
     //! \brief Registers an exception callback for an event_source.
     //!
@@ -72,7 +79,7 @@ public:
     //!
     //! If an exception callback is already registered for the given \a source, it is overwritten with the new callback.
 
-    void register_except_callback(event_source & source, event_source::event_callback callback);
+    void register_except_callback(event_source & source, event_source::event_callback callback) override;
 
     //! \brief Removes the readable callback for an event_source, if any.
     //!
@@ -80,7 +87,7 @@ public:
     //!
     //! If no callback is associated, this does nothing.
     
-    void remove_read_callback(event_source & source);
+    void remove_read_callback(event_source & source) override;
 
     //! \brief Removes the writable callback for an event_source, if any.
     //!
@@ -88,7 +95,7 @@ public:
     //!
     //! If no callback is associated, this does nothing.
 
-    void remove_write_callback(event_source & source);
+    void remove_write_callback(event_source & source) override;
 
     //! \brief Removes the exception callback for an event_source, if any.
     //!
@@ -96,7 +103,27 @@ public:
     //!
     //! If no callback is associated, this does nothing.
 
-    void remove_except_callback(event_source & source);
+    void remove_except_callback(event_source & source) override;
+
+    //! \brief Registers a unified handler for an event_source.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param handler - handler to be called with the ready events
+    //! \param interest - the events to monitor
+    //!
+    //! If a handler is already registered for the given \a source, it is overwritten with the new handler. No
+    //! per-event callbacks may be registered for \a source.
+
+    void register_handler(
+            event_source & source,
+            event_source::event_handler handler,
+            event_source::event_mask interest) override;
+
+    //! \brief Removes the unified handler for an event_source, if any.
+    //!
+    //! \param source - the event_source
+
+    void remove_handler(event_source & source) override;
 
     //! \brief \c iterator over the internal hashtable of an event_source_registry.
     typedef event_source_unordered_set::iterator iterator;
@@ -130,7 +157,7 @@ public:
     //!
     //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
     
-    inline event_source * find(int fd);
+    event_source * find(int fd) override;
 
     //! \brief Finds the event_source registered for a file descriptor.
     //!
@@ -138,7 +165,7 @@ public:
     //!
     //! \return the event_source, or \c nullptr if no event_source is associated with \a fd
         
-    inline event_source const * find(int fd) const;
+    event_source const * find(int fd) const override;
     
 private:
 
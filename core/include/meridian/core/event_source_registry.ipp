@@ -26,20 +26,6 @@ event_source_registry::const_iterator event_source_registry::end() const
 }
 
 
-event_source * event_source_registry::find(int fd)
-{
-    auto it = event_sources_.find(fd);
-    return it != event_sources_.end() ? &*it : nullptr;
-}
-
-
-event_source const * event_source_registry::find(int fd) const
-{
-    auto it = event_sources_.find(fd);
-    return it != event_sources_.end() ? &*it : nullptr;
-}
-
-
 void event_source_registry::erase_source_without_callback(event_source & source)
 {
     if (!source.has_callback()) {
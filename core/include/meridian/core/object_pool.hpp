@@ -0,0 +1,107 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__core__object_pool__hpp
+#define meridian__core__object_pool__hpp
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace meridian {
+namespace core {
+
+//! \brief A slab allocator for objects of one type, handing out owning handles which return objects to the pool.
+//! \class object_pool object_pool.hpp meridian/core/object_pool.hpp
+//!
+//! Objects are constructed in slots carved out of slabs, each holding a fixed number of objects. A free slot holds the
+//! link to the next free slot, so allocation and release are a pointer swap each, and the most recently released slot,
+//! which is likely still in cache, is the next one handed out. Slabs are allocated as the pool grows and kept until
+//! it's destroyed, so a server with high connection churn reaches a steady state in which it makes no calls to the
+//! global allocator at all, and its connections don't fragment the heap.
+//!
+//! make() returns a handle, a \c std::unique_ptr whose deleter destroys the object and puts its slot back on the free
+//! list instead of calling \c delete. The pool isn't thread-safe: keep one per thread (e.g., per reactor), and release
+//! handles on the thread which owns their pool. Every handle must be released before the pool is destroyed.
+//!
+//! \author Eric Crampton
+
+template <typename T>
+class object_pool {
+public:
+    //! \brief Returns an object to the pool it was made from.
+
+    class deleter {
+    public:
+        inline deleter() noexcept;
+        inline explicit deleter(object_pool & pool) noexcept;
+
+        inline void operator()(T * object) const noexcept;
+
+    private:
+        object_pool * pool_;
+    };
+
+    //! \brief An owning handle to an object made by an object_pool.
+    typedef std::unique_ptr<T, deleter> handle;
+
+    //! \brief Construction.
+    //!
+    //! \param slab_size - the number of objects each slab holds
+    //!
+    //! No memory is allocated until the first make().
+
+    explicit object_pool(size_t slab_size = 64);
+
+    //! \brief Destruction; frees the slabs. Every handle must have been released.
+
+    ~object_pool();
+
+    object_pool(object_pool const & pool) = delete;
+    object_pool & operator=(object_pool const & pool) = delete;
+
+    //! \brief Constructs an object from \a args in a free slot, allocating a slab if there is none.
+
+    template <typename... ARGS>
+    handle make(ARGS &&... args);
+
+    //! \brief Returns the number of objects which have been made and not yet released.
+
+    inline size_t size() const;
+
+    //! \brief Returns the number of slots in all slabs.
+
+    inline size_t capacity() const;
+
+private:
+    union slot {
+        slot * next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    //! \brief Allocates a slab and puts its slots on the free list.
+
+    void grow();
+
+    //! \brief Destroys \a object and puts its slot on the free list.
+
+    inline void release(T * object) noexcept;
+
+private:
+    size_t const slab_size_;
+    std::vector<std::unique_ptr<slot[]>> slabs_;
+    slot * free_;
+    size_t size_;
+};
+
+#include "meridian/core/object_pool.ipp"
+
+} // namespace core
+} // namespace meridian
+
+#endif /* meridian__core__object_pool__hpp */
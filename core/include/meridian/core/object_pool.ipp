@@ -0,0 +1,106 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename T>
+object_pool<T>::deleter::deleter() noexcept
+    : pool_(nullptr)
+{
+}
+
+
+template <typename T>
+object_pool<T>::deleter::deleter(object_pool & pool) noexcept
+    : pool_(&pool)
+{
+}
+
+
+template <typename T>
+void object_pool<T>::deleter::operator()(T * object) const noexcept
+{
+    pool_->release(object);
+}
+
+
+template <typename T>
+object_pool<T>::object_pool(size_t slab_size)
+    : slab_size_(slab_size ? slab_size : 1)
+    , slabs_()
+    , free_(nullptr)
+    , size_(0)
+{
+}
+
+
+template <typename T>
+object_pool<T>::~object_pool()
+{
+    assert(size_ == 0);
+}
+
+
+template <typename T>
+template <typename... ARGS>
+typename object_pool<T>::handle object_pool<T>::make(ARGS &&... args)
+{
+    if (!free_) {
+        grow();
+    }
+
+    slot * const allocated = free_;
+    free_ = allocated->next;
+
+    T * object;
+    try {
+        object = new (&allocated->storage) T(std::forward<ARGS>(args)...);
+    }
+    catch (...) {
+        allocated->next = free_;
+        free_ = allocated;
+        throw;
+    }
+
+    ++size_;
+    return handle(object, deleter(*this));
+}
+
+
+template <typename T>
+size_t object_pool<T>::size() const
+{
+    return size_;
+}
+
+
+template <typename T>
+size_t object_pool<T>::capacity() const
+{
+    return slabs_.size() * slab_size_;
+}
+
+
+template <typename T>
+void object_pool<T>::grow()
+{
+    slabs_.emplace_back(new slot[slab_size_]);
+    slot * const slab = slabs_.back().get();
+
+    for (size_t index = 0; index < slab_size_; ++index) {
+        slab[index].next = index + 1 < slab_size_ ? &slab[index + 1] : free_;
+    }
+
+    free_ = slab;
+}
+
+
+template <typename T>
+void object_pool<T>::release(T * object) noexcept
+{
+    object->~T();
+
+    slot * const released = reinterpret_cast<slot *>(object);
+    released->next = free_;
+    free_ = released;
+    --size_;
+}
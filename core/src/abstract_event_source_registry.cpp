@@ -0,0 +1,21 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/core/abstract_event_source_registry.hpp"
+
+namespace meridian {
+namespace core {
+
+abstract_event_source_registry::~abstract_event_source_registry()
+{
+}
+
+
+void abstract_event_source_registry::set_interest(event_source & source, event_source::event_mask interest)
+{
+    source.set_interest(interest);
+}
+
+} // namespace core
+} // namespace meridian
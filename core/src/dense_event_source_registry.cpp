@@ -0,0 +1,108 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/core/dense_event_source_registry.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace meridian {
+namespace core {
+
+dense_event_source_registry::dense_event_source_registry(size_t capacity)
+    : sources_(capacity, nullptr)
+{
+}
+
+
+void dense_event_source_registry::insert(event_source & source)
+{
+    int fd = source.fd();
+    assert(fd >= 0);
+
+    size_t index = static_cast<size_t>(fd);
+    if (index >= sources_.size()) {
+        sources_.resize(std::max(index + 1, sources_.size() * 2), nullptr);
+    }
+
+    assert(sources_[index] == nullptr || sources_[index] == &source);
+    sources_[index] = &source;
+}
+
+
+void dense_event_source_registry::register_read_callback(event_source & source, event_source::event_callback callback)
+{
+    insert(source);
+    source.set_read_callback(std::move(callback));
+}
+
+
+void dense_event_source_registry::register_write_callback(event_source & source, event_source::event_callback callback)
+{
+    insert(source);
+    source.set_write_callback(std::move(callback));
+}
+
+
+void dense_event_source_registry::register_except_callback(event_source & source, event_source::event_callback callback)
+{
+    insert(source);
+    source.set_except_callback(std::move(callback));
+}
+
+
+void dense_event_source_registry::remove_read_callback(event_source & source)
+{
+    assert(find(source.fd()) == &source);
+    source.remove_read_callback();
+    erase_source_without_callback(source);
+}
+
+
+void dense_event_source_registry::remove_write_callback(event_source & source)
+{
+    assert(find(source.fd()) == &source);
+    source.remove_write_callback();
+    erase_source_without_callback(source);
+}
+
+
+void dense_event_source_registry::remove_except_callback(event_source & source)
+{
+    assert(find(source.fd()) == &source);
+    source.remove_except_callback();
+    erase_source_without_callback(source);
+}
+
+void dense_event_source_registry::register_handler(
+        event_source & source,
+        event_source::event_handler handler,
+        event_source::event_mask interest)
+{
+    insert(source);
+    source.set_handler(std::move(handler), interest);
+}
+
+
+void dense_event_source_registry::remove_handler(event_source & source)
+{
+    assert(find(source.fd()) == &source);
+    source.remove_handler();
+    erase_source_without_callback(source);
+}
+
+
+event_source * dense_event_source_registry::find(int fd)
+{
+    return static_cast<size_t>(fd) < sources_.size() ? sources_[fd] : nullptr;
+}
+
+
+event_source const * dense_event_source_registry::find(int fd) const
+{
+    return static_cast<size_t>(fd) < sources_.size() ? sources_[fd] : nullptr;
+}
+
+} // namespace core
+} // namespace meridian
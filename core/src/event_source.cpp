@@ -7,9 +7,25 @@
 namespace meridian {
 namespace core {
 
+event_source::event_mask const event_source::READABLE;
+event_source::event_mask const event_source::WRITABLE;
+event_source::event_mask const event_source::EXCEPTION;
+size_t const event_source::SIZE_BUDGET;
+event_source::event_callback const event_source::NO_CALLBACK;
+event_source::event_handler const event_source::NO_HANDLER;
+
+
 event_source::event_source(int fd)
     : fd_(fd)
+    , handler_interest_(0)
+    , slot_(slot_content::empty)
+{
+}
+
+
+event_source::~event_source()
 {
+    clear_slot();
 }
 
 } // namespace core
@@ -21,13 +21,18 @@ event_source_registry::event_source_registry(event_source_registry && registry)
 }
 
 
+event_source_registry::~event_source_registry()
+{
+}
+
+
 void event_source_registry::register_read_callback(event_source & source, event_source::event_callback callback)
 {
     if (!source.is_linked()) {
         event_sources_.insert(source);
     }
 
-    source.set_read_callback(callback);
+    source.set_read_callback(std::move(callback));
 }
 
 
@@ -37,7 +42,7 @@ void event_source_registry::register_write_callback(event_source & source, event
         event_sources_.insert(source);
     }
 
-    source.set_write_callback(callback);
+    source.set_write_callback(std::move(callback));
 }
 
 
@@ -47,7 +52,7 @@ void event_source_registry::register_except_callback(event_source & source, even
         event_sources_.insert(source);
     }
 
-    source.set_except_callback(callback);
+    source.set_except_callback(std::move(callback));
 }
 
 
@@ -74,5 +79,39 @@ void event_source_registry::remove_except_callback(event_source & source)
     erase_source_without_callback(source);
 }
 
+void event_source_registry::register_handler(
+        event_source & source,
+        event_source::event_handler handler,
+        event_source::event_mask interest)
+{
+    if (!source.is_linked()) {
+        event_sources_.insert(source);
+    }
+
+    source.set_handler(std::move(handler), interest);
+}
+
+
+void event_source_registry::remove_handler(event_source & source)
+{
+    assert(source.is_linked());
+    source.remove_handler();
+    erase_source_without_callback(source);
+}
+
+
+event_source * event_source_registry::find(int fd)
+{
+    auto it = event_sources_.find(fd);
+    return it != event_sources_.end() ? &*it : nullptr;
+}
+
+
+event_source const * event_source_registry::find(int fd) const
+{
+    auto it = event_sources_.find(fd);
+    return it != event_sources_.end() ? &*it : nullptr;
+}
+
 } // namespace core
 } // namespace meridian
@@ -0,0 +1,144 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+#include "meridian/core/delegate.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+using meridian::core::delegate;
+
+namespace {
+
+struct counted {
+    static int copies;
+    static int live;
+
+    counted() { ++live; }
+    counted(counted const &) { ++copies; ++live; }
+    counted(counted &&) noexcept { ++live; }
+    ~counted() { --live; }
+
+    void operator()(int & calls) const { ++calls; }
+};
+
+int counted::copies = 0;
+int counted::live = 0;
+
+struct handler {
+    void on_event() { ++calls; }
+    int calls = 0;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(delegate_tests)
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    delegate<void ()> empty;
+    BOOST_CHECK(!empty);
+
+    delegate<void ()> null(nullptr);
+    BOOST_CHECK(!null);
+}
+
+BOOST_AUTO_TEST_CASE(test_member_bind_is_inline)
+{
+    handler h;
+    auto bound = std::bind(&handler::on_event, &h);
+    BOOST_CHECK(delegate<void ()>::is_inline<decltype(bound)>::value);
+
+    delegate<void ()> callback(bound);
+    callback();
+    callback();
+    BOOST_CHECK_EQUAL(h.calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_invocation_and_moves_do_not_copy)
+{
+    counted::copies = 0;
+    counted::live = 0;
+    {
+        delegate<void (int &)> first{ counted() };
+        int calls = 0;
+        first(calls);
+
+        delegate<void (int &)> second(std::move(first));
+        BOOST_CHECK(!first);
+        second(calls);
+
+        first = std::move(second);
+        first(calls);
+
+        BOOST_CHECK_EQUAL(calls, 3);
+        BOOST_CHECK_EQUAL(counted::live, 1);
+    }
+    BOOST_CHECK_EQUAL(counted::copies, 0);
+    BOOST_CHECK_EQUAL(counted::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_large_callable_falls_back_to_heap)
+{
+    std::array<int, 16> values{};
+    values[15] = 7;
+    auto large = [values](int & out) { out = values[15]; };
+    BOOST_CHECK(!delegate<void (int &)>::is_inline<decltype(large)>::value);
+
+    delegate<void (int &)> first(large);
+    delegate<void (int &)> second(std::move(first));
+    int out = 0;
+    second(out);
+    BOOST_CHECK_EQUAL(out, 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_reset_destroys_callable)
+{
+    std::shared_ptr<int> state = std::make_shared<int>(0);
+    delegate<int ()> callback([state] { return ++*state; });
+    BOOST_CHECK_EQUAL(callback(), 1);
+    BOOST_CHECK_EQUAL(state.use_count(), 2);
+
+    callback = nullptr;
+    BOOST_CHECK(!callback);
+    BOOST_CHECK_EQUAL(state.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_invoke_detached_survives_reset)
+{
+    std::shared_ptr<int> state = std::make_shared<int>(0);
+    std::unique_ptr<delegate<int ()>> holder(new delegate<int ()>);
+    bool held_during_call = false;
+
+    // The callable destroys the delegate holding it, then still uses its own captures.
+    *holder = [state, &holder, &held_during_call] {
+        held_during_call = static_cast<bool>(*holder);
+        holder.reset();
+        return ++*state;
+    };
+    BOOST_CHECK_EQUAL(holder->invoke_detached(), 1);
+    BOOST_CHECK(held_during_call);
+    BOOST_CHECK(!holder);
+    BOOST_CHECK_EQUAL(state.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_invoke_detached_restores_callable)
+{
+    std::shared_ptr<int> state = std::make_shared<int>(0);
+    delegate<int ()> callback([state] { return ++*state; });
+
+    BOOST_CHECK_EQUAL(callback.invoke_detached(), 1);
+    BOOST_CHECK_EQUAL(callback.invoke_detached(), 2);
+    BOOST_CHECK_EQUAL(state.use_count(), 2);
+
+    // A callable replacing its own delegate keeps the replacement.
+    delegate<int ()> replacing;
+    replacing = [&replacing] { replacing = [] { return 2; }; return 1; };
+    BOOST_CHECK_EQUAL(replacing.invoke_detached(), 1);
+    BOOST_CHECK_EQUAL(replacing(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
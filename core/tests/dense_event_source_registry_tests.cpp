@@ -0,0 +1,63 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+#include "meridian/core/dense_event_source_registry.hpp"
+
+using meridian::core::dense_event_source_registry;
+using meridian::core::event_source;
+
+namespace {
+
+struct test_event_source : event_source {
+    explicit test_event_source(int fd) : event_source(fd) { }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(dense_event_source_registry_tests)
+
+BOOST_AUTO_TEST_CASE(test_find_follows_callbacks)
+{
+    dense_event_source_registry registry(8);
+    test_event_source source(3);
+
+    BOOST_CHECK(registry.find(3) == nullptr);
+    BOOST_CHECK(registry.find(-1) == nullptr);
+
+    registry.register_read_callback(source, [] { });
+    registry.register_write_callback(source, [] { });
+    BOOST_CHECK(registry.find(3) == &source);
+
+    registry.remove_read_callback(source);
+    BOOST_CHECK(registry.find(3) == &source);
+
+    registry.remove_write_callback(source);
+    BOOST_CHECK(registry.find(3) == nullptr);
+    BOOST_CHECK(!source.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_grows_on_demand)
+{
+    dense_event_source_registry registry(4);
+    test_event_source low(1);
+    test_event_source high(1000);
+
+    registry.register_read_callback(low, [] { });
+    registry.register_except_callback(high, [] { });
+    BOOST_CHECK_GE(registry.capacity(), 1001u);
+    BOOST_CHECK(registry.find(1) == &low);
+    BOOST_CHECK(registry.find(1000) == &high);
+    BOOST_CHECK(registry.find(1001) == nullptr);
+
+    // Reactors find sources through the interface.
+    meridian::core::abstract_event_source_registry const & base = registry;
+    BOOST_CHECK(base.find(1000) == &high);
+
+    registry.remove_except_callback(high);
+    registry.remove_read_callback(low);
+    BOOST_CHECK(registry.find(1000) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
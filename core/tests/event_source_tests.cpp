@@ -0,0 +1,116 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+#include "meridian/core/event_source_registry.hpp"
+
+using meridian::core::event_source;
+using meridian::core::event_source_registry;
+
+namespace {
+
+struct test_event_source : event_source {
+    explicit test_event_source(int fd) : event_source(fd) { }
+};
+
+}
+
+// The budget is stated for LP64; elsewhere pointers (and so the hook and the delegates) are a different size.
+static_assert(sizeof(void *) != 8 || sizeof(event_source) <= event_source::SIZE_BUDGET,
+              "event_source has outgrown its size budget");
+
+BOOST_AUTO_TEST_SUITE(event_source_tests)
+
+BOOST_AUTO_TEST_CASE(test_size_budget)
+{
+    BOOST_TEST_MESSAGE("sizeof(event_source) == " << sizeof(event_source));
+
+    if (sizeof(void *) == 8) {
+        BOOST_CHECK_LE(sizeof(event_source), event_source::SIZE_BUDGET);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_interest_follows_registrations)
+{
+    event_source_registry registry;
+    test_event_source source(3);
+
+    BOOST_CHECK_EQUAL(source.interest(), 0);
+    BOOST_CHECK(!source.read_callback());
+
+    registry.register_read_callback(source, [] { });
+    registry.register_except_callback(source, [] { });
+    BOOST_CHECK_EQUAL(source.interest(), event_source::READABLE | event_source::EXCEPTION);
+
+    registry.remove_read_callback(source);
+    registry.remove_except_callback(source);
+    BOOST_CHECK_EQUAL(source.interest(), 0);
+    BOOST_CHECK(!source.has_callback());
+
+    registry.register_handler(source, [](event_source::event_mask) { }, event_source::WRITABLE);
+    BOOST_CHECK(source.has_handler());
+    BOOST_CHECK_EQUAL(source.interest(), event_source::WRITABLE);
+
+    registry.set_interest(source, event_source::READABLE | event_source::WRITABLE);
+    BOOST_CHECK_EQUAL(source.interest(), event_source::READABLE | event_source::WRITABLE);
+
+    registry.remove_handler(source);
+    BOOST_CHECK(!source.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_callbacks_in_and_out_of_the_inline_slot)
+{
+    event_source_registry registry;
+    test_event_source source(3);
+    int reads = 0;
+    int writes = 0;
+    int excepts = 0;
+
+    // The first callback takes the inline slot; the others are stored out of line.
+    registry.register_write_callback(source, [&writes] { ++writes; });
+    registry.register_read_callback(source, [&reads] { ++reads; });
+    registry.register_except_callback(source, [&excepts] { ++excepts; });
+    source.invoke_read_callback();
+    source.invoke_write_callback();
+    source.invoke_except_callback();
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+    BOOST_CHECK_EQUAL(excepts, 1);
+
+    // Once the slot is freed, the next callback registered moves into it.
+    registry.remove_write_callback(source);
+    registry.register_read_callback(source, [&reads] { reads += 10; });
+    BOOST_CHECK_EQUAL(source.interest(), event_source::READABLE | event_source::EXCEPTION);
+    source.invoke_read_callback();
+    BOOST_CHECK_EQUAL(reads, 11);
+
+    registry.remove_read_callback(source);
+    registry.remove_except_callback(source);
+    BOOST_CHECK(!source.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_inline_callback_replaces_itself)
+{
+    event_source_registry registry;
+    test_event_source source(3);
+    event_source::event_mask handled = 0;
+
+    // The callback being invoked is destroyed, and a handler is constructed in the same slot.
+    registry.register_read_callback(source, [&] {
+        registry.remove_read_callback(source);
+        registry.register_handler(source, [&handled](event_source::event_mask ready) { handled = ready; },
+                                  event_source::READABLE);
+    });
+
+    source.invoke_read_callback();
+    BOOST_CHECK(!source.has_read_callback());
+    BOOST_REQUIRE(source.has_handler());
+
+    source.invoke_handler(event_source::READABLE);
+    BOOST_CHECK_EQUAL(handled, event_source::READABLE);
+
+    registry.remove_handler(source);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
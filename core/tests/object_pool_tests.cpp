@@ -0,0 +1,106 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/core/object_pool.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using meridian::core::object_pool;
+
+namespace {
+
+struct tracked {
+    tracked(int & live, std::string value) : live(live), value(std::move(value)) { ++live; }
+    ~tracked() { --live; }
+
+    int & live;
+    std::string value;
+};
+
+struct throws_on_construction {
+    throws_on_construction() { throw std::runtime_error("construction"); }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(object_pool_tests)
+
+BOOST_AUTO_TEST_CASE(test_make_and_release)
+{
+    object_pool<tracked> pool(4);
+    int live = 0;
+
+    BOOST_CHECK_EQUAL(pool.capacity(), 0u);
+
+    {
+        object_pool<tracked>::handle first = pool.make(live, "first");
+        object_pool<tracked>::handle second = pool.make(live, "second");
+
+        BOOST_CHECK_EQUAL(first->value, "first");
+        BOOST_CHECK_EQUAL(second->value, "second");
+        BOOST_CHECK_EQUAL(live, 2);
+        BOOST_CHECK_EQUAL(pool.size(), 2u);
+        BOOST_CHECK_EQUAL(pool.capacity(), 4u);
+    }
+
+    BOOST_CHECK_EQUAL(live, 0);
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_released_slot_is_reused)
+{
+    object_pool<tracked> pool(4);
+    int live = 0;
+
+    tracked * address = nullptr;
+    {
+        object_pool<tracked>::handle object = pool.make(live, "a");
+        address = object.get();
+    }
+
+    object_pool<tracked>::handle object = pool.make(live, "b");
+    BOOST_CHECK_EQUAL(object.get(), address);
+    BOOST_CHECK_EQUAL(object->value, "b");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_grows_by_slabs)
+{
+    object_pool<tracked> pool(4);
+    int live = 0;
+
+    std::vector<object_pool<tracked>::handle> objects;
+    for (int i = 0; i < 9; ++i) {
+        objects.push_back(pool.make(live, std::to_string(i)));
+    }
+
+    BOOST_CHECK_EQUAL(pool.size(), 9u);
+    BOOST_CHECK_EQUAL(pool.capacity(), 12u);
+
+    for (int i = 0; i < 9; ++i) {
+        BOOST_CHECK_EQUAL(objects[i]->value, std::to_string(i));
+    }
+
+    objects.clear();
+    BOOST_CHECK_EQUAL(live, 0);
+    BOOST_CHECK_EQUAL(pool.capacity(), 12u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_throwing_constructor_keeps_slot_free)
+{
+    object_pool<throws_on_construction> pool(1);
+
+    BOOST_CHECK_THROW(pool.make(), std::runtime_error);
+    BOOST_CHECK_THROW(pool.make(), std::runtime_error);
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+    BOOST_CHECK_EQUAL(pool.capacity(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,54 +2,57 @@
 // Distributed under the Boost Software License, Version 1.0.
 // (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#include "meridian/reactor/select_reactor.hpp"
+#include "meridian/network/sharded_runtime.hpp"
 #include "meridian/network/stream_socket.hpp"
 #include "meridian/network/ip_address_family.hpp"
 
-#include <functional>
+#include <iostream>
+#include <sstream>
+
+//! \brief Greets each connection and closes it, with one thread per core.
+//!
+//! Every shard of the runtime accepts on its own \c SO_REUSEPORT listener and serves the connections it accepts, so
+//! the server scales with the number of cores and no connection ever moves between threads.
 
 class echo_server {
 public:
     echo_server(in_port_t listen_port)
-        : accept_socket_(meridian::network::socket_domain::inet)
-        , reactor_()
+        : runtime_()
     {
-        accept_socket_.set_reuse_address(true);
-
-        accept_socket_.bind(
+        runtime_.listen(
                 meridian::network::socket_address::create_inet_address(
                         meridian::network::ip_address(),
-                        listen_port));
-
-        accept_socket_.listen(5);
+                        listen_port),
+                128,
+                [](meridian::network::sharded_runtime::shard & shard,
+                   meridian::network::stream_socket::pool::handle client,
+                   meridian::network::socket_address const & client_address) {
+                    on_connection(shard, std::move(client), client_address);
+                });
     }
 
     void run() {
-        meridian::reactor::select_reactor::scoped_registration<meridian::reactor::event_type::read> registration(
-                reactor_,
-                accept_socket_,
-                std::bind(&echo_server::on_connection, this));
-        
-        while (true) {
-            reactor_.wait_for_events();
-        }
+        runtime_.start();
+        runtime_.join();
     }
     
 private:
-    void on_connection()
+    static void on_connection(
+            meridian::network::sharded_runtime::shard & shard,
+            meridian::network::stream_socket::pool::handle client,
+            meridian::network::socket_address const & client_address)
     {
-        meridian::network::socket_address client_address;
-        std::unique_ptr<meridian::network::stream_socket> client = accept_socket_.accept(client_address);
-        
-        std::cout << "connection from " << client_address << '\n';
+        // Built up front so lines from different shards don't interleave.
+        std::ostringstream message;
+        message << "shard " << shard.index() << ": connection from " << client_address << '\n';
+        std::cout << message.str();
 
         client->send("hello!\n", 7, 0);
         client->close();
     }
 
 private:
-    meridian::network::stream_socket accept_socket_;
-    meridian::reactor::select_reactor reactor_;
+    meridian::network::sharded_runtime runtime_;
 };
 
 int main()
@@ -0,0 +1,104 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__adaptive_receiver__hpp
+#define meridian__network__adaptive_receiver__hpp
+
+#include "meridian/network/io_result.hpp"
+#include "meridian/network/receive_buffer_pool.hpp"
+#include "meridian/network/stream_socket.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace meridian {
+namespace network {
+
+//! \brief Receives on a connection into a pooled buffer sized from the connection's recent reads.
+//! \class adaptive_receiver adaptive_receiver.hpp meridian/network/adaptive_receiver.hpp
+//!
+//! A fixed receive buffer is either too large for most connections, wasting memory on every idle one, or too small
+//! for bulk ones, costing extra reads. An adaptive_receiver predicts the size of the next read instead, and borrows a
+//! buffer of that size from a receive_buffer_pool for just that read, so an idle connection holds no buffer at all;
+//! it costs a connection only these few words.
+//!
+//! The prediction is a power of two between the minimum and maximum sizes, kept near a moving average of recent reads
+//! (each read weighing a quarter). It grows quickly and shrinks slowly: a read which fills the buffer doubles the
+//! next size at once, while the size halves, one step per read, only once the average has fallen to half of it or
+//! less. Optionally, after a read which filled the buffer, and only then, \c FIONREAD (socket::available()) is asked
+//! how much more is queued, so a bulk transfer reaches its size in one step rather than several.
+//!
+//! The predictor may be used on its own, with next_size() and record(), e.g., to size buffer_chain::read_from().
+//!
+//! \author Eric Crampton
+
+class adaptive_receiver {
+public:
+    //! \brief Construction.
+    //!
+    //! \param initial - the size of the first read
+    //! \param minimum - the smallest read
+    //! \param maximum - the largest read, at most the largest receive_buffer_pool class
+    //! \param use_available - whether to ask \c FIONREAD after a read which filled its buffer
+    //!
+    //! Sizes are rounded up to powers of two, and clamped to the largest receive_buffer_pool class.
+
+    explicit adaptive_receiver(
+            size_t initial = 2048,
+            size_t minimum = receive_buffer_pool::SMALLEST,
+            size_t maximum = receive_buffer_pool::class_size(receive_buffer_pool::CLASSES - 1),
+            bool use_available = true) noexcept;
+
+    //! \brief Receives once into a buffer borrowed from \a pool, and passes what arrived to \a sink.
+    //!
+    //! \param socket - the socket to receive on, usually non-blocking
+    //! \param sink - called as <tt>sink(char const * data, size_t bytes)</tt> if any bytes arrived; the buffer goes
+    //! back to \a pool once it returns
+    //! \param pool - where to borrow the buffer from
+    //! \param flags - flags for \c recv (2)
+    //!
+    //! \return the result of the receive; 0 bytes means the peer has closed the connection
+
+    template <typename SINK>
+    io_result receive(
+            stream_socket & socket,
+            SINK sink,
+            receive_buffer_pool & pool = receive_buffer_pool::local(),
+            int flags = 0);
+
+    //! \brief Returns the predicted size of the next read.
+
+    inline size_t next_size() const noexcept;
+
+    //! \brief Updates the prediction with the \a bytes returned by a read of next_size() bytes.
+
+    void record(size_t bytes) noexcept;
+
+    //! \brief Updates the prediction with the knowledge that \a bytes are queued to be read.
+
+    void hint(size_t bytes) noexcept;
+
+private:
+    //! \brief Returns the smallest power of two no less than \a size, clamped to [minimum_, maximum_].
+
+    size_t clamp(size_t size) const noexcept;
+
+    //! \brief Returns the smallest power of two no less than \a size, up to 2^31.
+
+    static uint32_t round_up_to_power_of_two(size_t size) noexcept;
+
+private:
+    uint32_t minimum_;
+    uint32_t maximum_;
+    uint32_t size_;
+    uint32_t average_;
+    bool use_available_;
+};
+
+#include "meridian/network/adaptive_receiver.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__adaptive_receiver__hpp */
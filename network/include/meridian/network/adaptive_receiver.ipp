@@ -0,0 +1,34 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename SINK>
+io_result adaptive_receiver::receive(stream_socket & socket, SINK sink, receive_buffer_pool & pool, int flags)
+{
+    receive_buffer_pool::buffer buffer = pool.acquire(next_size());
+    size_t const size = std::min(next_size(), buffer.size());
+
+    io_result result = socket.receive(buffer.data(), size, flags, std::nothrow);
+    if (!result.ok() || result.bytes() == 0) {
+        return result;
+    }
+
+    sink(static_cast<char const *>(buffer.data()), result.bytes());
+
+    // The hint only sizes the next read, so if FIONREAD fails there's simply no hint.
+    record(result.bytes());
+    if (use_available_ && result.bytes() == size) {
+        io_result const available = socket.available(std::nothrow);
+        if (available.ok()) {
+            hint(available.bytes());
+        }
+    }
+
+    return result;
+}
+
+
+size_t adaptive_receiver::next_size() const noexcept
+{
+    return size_;
+}
@@ -0,0 +1,212 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__buffer_chain__hpp
+#define meridian__network__buffer_chain__hpp
+
+#include "meridian/core/delegate.hpp"
+#include "meridian/core/object_pool.hpp"
+#include "meridian/network/io_result.hpp"
+#include "meridian/network/stream_socket.hpp"
+
+#include <deque>
+#include <sys/uio.h>
+
+namespace meridian {
+namespace network {
+
+//! \brief A byte queue for stream I/O, held as a chain of fixed-size segments rather than one contiguous buffer.
+//! \class buffer_chain buffer_chain.hpp meridian/network/buffer_chain.hpp
+//!
+//! Data is appended at the back and consumed from the front, as a connection's input and output buffers are. Since
+//! the bytes live in separate segments, growing never reallocates and consuming never moves what's left: a partial
+//! read or write only adjusts the segments at either end. Segments come from a segment_pool, one per thread by
+//! default, so a connection's memory is bounded by the data it actually holds, in SEGMENT_SIZE steps, and a released
+//! segment is reused by the next connection which needs one.
+//!
+//! Besides copying, the chain can take data without copying it:
+//!
+//! - append(buffer_chain &&) and prepend(buffer_chain &&) move another chain's segments over;
+//! - append_reference() and prepend_reference() link caller-owned memory into the chain, with a callback to release
+//!   it once the chain has consumed it. A response body can be queued between a header and a trailer this way.
+//!
+//! The chain maps directly onto vectored I/O. write_to() gathers the readable segments into one \c sendmsg (2), and
+//! read_from() scatters a \c recvmsg (2) across free space at the back. peek() and reserve() with commit() expose the
+//! same for other calls. copy_out() and find() look across segment boundaries without linearizing the chain.
+//!
+//! A chain using the thread's pool must be destroyed on that thread, before the thread exits.
+//!
+//! \author Eric Crampton
+
+class buffer_chain {
+public:
+    //! \brief The size of a pooled segment.
+    static size_t const SEGMENT_SIZE = 4096;
+
+    //! \brief The most segments used by one write_to() or read_from().
+    static size_t const MAX_VECTORS = 64;
+
+    //! \brief Returned by find() if there's no match.
+    static size_t const npos = static_cast<size_t>(-1);
+
+    //! \brief A pooled segment's storage, left uninitialized when it's made.
+    struct segment {
+        segment() { }
+        char bytes[SEGMENT_SIZE];
+    };
+
+    //! \brief The pool segments are drawn from.
+    typedef core::object_pool<segment> segment_pool;
+
+    //! \brief Called once referenced memory is no longer needed.
+    typedef core::delegate<void ()> release_callback;
+
+    //! \brief Returns this thread's segment pool.
+
+    static segment_pool & local_pool();
+
+    //! \brief Construction.
+    //!
+    //! \param pool - where to draw segments from
+
+    explicit buffer_chain(segment_pool & pool = local_pool());
+
+    buffer_chain(buffer_chain && chain);
+    buffer_chain & operator=(buffer_chain && chain);
+
+    buffer_chain(buffer_chain const & chain) = delete;
+    buffer_chain & operator=(buffer_chain const & chain) = delete;
+
+    //! \brief Returns the number of readable bytes.
+
+    inline size_t size() const noexcept;
+
+    //! \brief Returns true if there are no readable bytes.
+
+    inline bool empty() const noexcept;
+
+    //! \brief Returns the number of segments held, including reserved ones.
+
+    inline size_t segment_count() const noexcept;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Adding and removing data
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Copies \a length bytes onto the back, filling the last segment before drawing new ones.
+
+    void append(void const * data, size_t length);
+
+    //! \brief Links \a length bytes at \a data onto the back without copying; \a release is called once they've
+    //! been consumed (or the chain is destroyed), and until then they must stay valid and unchanged.
+
+    void append_reference(void const * data, size_t length, release_callback release = nullptr);
+
+    //! \brief Moves all of \a chain's data onto the back, leaving \a chain empty.
+
+    void append(buffer_chain && chain);
+
+    //! \brief Copies \a length bytes onto the front, using free space before the first byte if there is any.
+
+    void prepend(void const * data, size_t length);
+
+    //! \brief Links \a length bytes at \a data onto the front without copying.
+
+    void prepend_reference(void const * data, size_t length, release_callback release = nullptr);
+
+    //! \brief Moves all of \a chain's data onto the front, leaving \a chain empty.
+
+    void prepend(buffer_chain && chain);
+
+    //! \brief Discards the first \a length bytes (at most size()), releasing the segments they leave empty.
+
+    void consume(size_t length);
+
+    //! \brief Discards everything, releasing every segment.
+
+    void clear();
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Looking at data
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Copies up to \a length bytes, starting \a offset bytes from the front, to \a buffer.
+    //!
+    //! \return the number of bytes copied
+
+    size_t copy_out(void * buffer, size_t length, size_t offset = 0) const;
+
+    //! \brief Returns the offset of the first occurrence of the \a length bytes at \a pattern, starting the search
+    //! \a from bytes from the front; or npos.
+
+    size_t find(void const * pattern, size_t length, size_t from = 0) const;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Vectored I/O
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Describes the readable bytes, front first, in up to \a count segments at \a vectors.
+    //!
+    //! \return the number of segments described
+
+    size_t peek(iovec * vectors, size_t count) const;
+
+    //! \brief Makes at least \a length bytes of free space at the back, and describes it in up to \a count segments
+    //! at \a vectors.
+    //!
+    //! \return the number of segments described, which may cover less than \a length bytes if \a count is too small
+    //!
+    //! Call commit() once data has been written into the space.
+
+    size_t reserve(size_t length, iovec * vectors, size_t count);
+
+    //! \brief Makes \a length bytes written into the space from reserve() readable, and releases segments of the
+    //! space which are still entirely unused.
+
+    void commit(size_t length);
+
+    //! \brief Sends as much of the chain as \a socket will take, in one call, and consumes what was sent.
+
+    io_result write_to(stream_socket & socket, int flags = 0);
+
+    //! \brief Receives up to \a length bytes from \a socket onto the back, in one call.
+
+    io_result read_from(stream_socket & socket, size_t length = SEGMENT_SIZE, int flags = 0);
+
+private:
+    //! \brief A run of bytes: a pooled segment, or referenced memory.
+    struct node {
+        inline explicit node(segment_pool::handle pooled) noexcept;
+        inline node(void const * data, size_t length, release_callback release) noexcept;
+        inline node(node && other) noexcept;
+        inline node & operator=(node && other) noexcept;
+        inline ~node();
+
+        inline size_t readable() const noexcept;
+        inline size_t writable() const noexcept;
+
+        char * data;
+        size_t begin;                  //!< readable bytes are [begin, end)
+        size_t end;
+        size_t capacity;               //!< writable bytes are [end, capacity); referenced memory has none
+        segment_pool::handle storage;
+        release_callback release;
+    };
+
+    //! \brief Releases empty segments at the back.
+
+    void trim_back() noexcept;
+
+private:
+    segment_pool * pool_;
+    std::deque<node> nodes_;
+    size_t size_;
+};
+
+#include "meridian/network/buffer_chain.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__buffer_chain__hpp */
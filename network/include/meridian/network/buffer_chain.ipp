@@ -0,0 +1,92 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+size_t buffer_chain::size() const noexcept
+{
+    return size_;
+}
+
+
+bool buffer_chain::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+
+size_t buffer_chain::segment_count() const noexcept
+{
+    return nodes_.size();
+}
+
+
+buffer_chain::node::node(segment_pool::handle pooled) noexcept
+    : data(pooled->bytes)
+    , begin(0)
+    , end(0)
+    , capacity(SEGMENT_SIZE)
+    , storage(std::move(pooled))
+    , release()
+{
+}
+
+
+buffer_chain::node::node(void const * data, size_t length, release_callback release) noexcept
+    : data(static_cast<char *>(const_cast<void *>(data)))
+    , begin(0)
+    , end(length)
+    , capacity(length)
+    , storage()
+    , release(std::move(release))
+{
+}
+
+
+buffer_chain::node::node(node && other) noexcept
+    : data(other.data)
+    , begin(other.begin)
+    , end(other.end)
+    , capacity(other.capacity)
+    , storage(std::move(other.storage))
+    , release(std::move(other.release))
+{
+    other.release = nullptr;
+}
+
+
+buffer_chain::node & buffer_chain::node::operator=(node && other) noexcept
+{
+    if (release) {
+        release();
+    }
+
+    data = other.data;
+    begin = other.begin;
+    end = other.end;
+    capacity = other.capacity;
+    storage = std::move(other.storage);
+    release = std::move(other.release);
+    other.release = nullptr;
+
+    return *this;
+}
+
+
+buffer_chain::node::~node()
+{
+    if (release) {
+        release();
+    }
+}
+
+
+size_t buffer_chain::node::readable() const noexcept
+{
+    return end - begin;
+}
+
+
+size_t buffer_chain::node::writable() const noexcept
+{
+    return storage ? capacity - end : 0;
+}
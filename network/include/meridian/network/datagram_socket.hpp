@@ -0,0 +1,167 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__datagram_socket__hpp
+#define meridian__network__datagram_socket__hpp
+
+#include "meridian/network/exception.hpp"
+#include "meridian/network/socket.hpp"
+#include "meridian/network/socket_domain.hpp"
+
+#include <cstdint>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+namespace meridian {
+namespace network {
+
+//! \brief One datagram of a batch passed to datagram_socket::receive_batch() or datagram_socket::send_batch().
+//!
+//! The caller owns the buffers and keeps an array of these for reuse, so a batch costs no allocation.
+
+struct datagram {
+    void * buffer;          //!< the payload
+    size_t capacity;        //!< the size of \a buffer (receive only)
+    size_t length;          //!< the payload's length: set by a receive; to be set by the caller for a send
+    socket_address address; //!< the sender's address (receive), or the destination (send)
+    bool truncated;         //!< set by a receive if the datagram didn't fit in \a capacity bytes
+};
+
+//! \brief A datagram socket (e.g., UDP), with batched receive and send.
+//! \class datagram_socket datagram_socket.hpp meridian/network/datagram_socket.hpp
+//!
+//! receive_batch() and send_batch() move up to a whole array of datagrams with one \c recvmmsg (2) or
+//! \c sendmmsg (2), so a server handling many small datagrams pays one system call per batch rather than one per
+//! datagram. On systems without those calls, they loop over \c recvmsg (2) and \c sendmsg (2) instead.
+//!
+//! For bulk UDP, send_segmented() and receive_segmented() go further with Linux's segmentation offload: one large
+//! buffer is passed to the kernel with a segment size and split into datagrams below the socket layer (GSO), and with
+//! set_udp_gro() enabled, consecutive datagrams from one sender arrive as one coalesced buffer which
+//! for_each_segment() splits apart again (GRO).
+//!
+//! \author Eric Crampton
+
+class datagram_socket : public socket {
+public:
+    using socket::bind;
+    using socket::receive;
+    using socket::send;
+    using socket::receive_from;
+    using socket::send_to;
+    using socket::send_vectored;
+    using socket::receive_vectored;
+    using socket::send_message;
+    using socket::receive_message;
+
+    //! \brief The most datagrams moved by one system call; larger batches take several.
+    static size_t const MAX_BATCH = 64;
+
+    explicit datagram_socket(socket_domain domain, int protocol = 0);
+    explicit datagram_socket(int fd) : socket(fd) { }
+
+    //! \brief Connects the socket to \a address, which becomes the destination of send() and the only source
+    //! receive() accepts.
+
+    void connect(socket_address const & address);
+
+    //! \brief Receives up to \a count datagrams into \a datagrams.
+    //!
+    //! \return the number of datagrams received, which are the first ones of \a datagrams
+    //!
+    //! Waits (on a blocking socket) only for the first datagram; the rest of the batch is whatever has already
+    //! arrived. Throws on error, including \c EAGAIN before any datagram has arrived.
+
+    size_t receive_batch(datagram * datagrams, size_t count, int flags = 0);
+
+    //! \brief Sends up to \a count datagrams from \a datagrams, each to its address.
+    //!
+    //! \return the number of datagrams sent, which are the first ones of \a datagrams
+    //!
+    //! Throws on error if no datagram could be sent; otherwise the error is left for the next call to report.
+
+    size_t send_batch(datagram const * datagrams, size_t count, int flags = 0);
+
+    //! \brief Receives up to \a count datagrams without throwing; bytes() of the result is the number received.
+
+    io_result receive_batch(datagram * datagrams, size_t count, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Sends up to \a count datagrams without throwing; bytes() of the result is the number sent.
+
+    io_result send_batch(datagram const * datagrams, size_t count, int flags, std::nothrow_t const &) noexcept;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name UDP segmentation offload (Linux)
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Sets or clears \c UDP_GRO, which lets receive_segmented() return coalesced runs of datagrams.
+    //!
+    //! Throws unsupported_operation_exception on systems without \c UDP_GRO.
+
+    void set_udp_gro(bool flag);
+    bool get_udp_gro() const;
+
+    //! \brief Sends \a length bytes from \a buffer as datagrams of \a segment_size bytes each, the last possibly
+    //! shorter, with one system call (\c UDP_SEGMENT).
+    //!
+    //! \param address - the destination; an empty socket_address for a connected socket
+    //!
+    //! \return the number of bytes sent
+    //!
+    //! The kernel limits a call to 64 segments and a total that fits one IP datagram (about 64 KiB).
+
+    size_t send_segmented(
+            void const * buffer,
+            size_t length,
+            std::uint16_t segment_size,
+            socket_address const & address,
+            int flags = 0);
+
+    //! \brief Receives a datagram or, with set_udp_gro() enabled, a coalesced run of datagrams from one sender.
+    //!
+    //! \param address - receives the sender's address
+    //! \param segment_size - receives the size of each datagram in the run but the last, which may be shorter; if
+    //! the kernel didn't coalesce, this is the number of bytes received
+    //!
+    //! \return the number of bytes received; pass them to for_each_segment() to split the run into datagrams
+
+    size_t receive_segmented(
+            void * buffer,
+            size_t capacity,
+            socket_address & address,
+            size_t & segment_size,
+            int flags = 0);
+
+    //! \brief Sends segmented datagrams without throwing; fails with \c ENOPROTOOPT off Linux.
+
+    io_result send_segmented(
+            void const * buffer,
+            size_t length,
+            std::uint16_t segment_size,
+            socket_address const & address,
+            int flags,
+            std::nothrow_t const &) noexcept;
+
+    //! \brief Receives a datagram or a coalesced run without throwing.
+
+    io_result receive_segmented(
+            void * buffer,
+            size_t capacity,
+            socket_address & address,
+            size_t & segment_size,
+            int flags,
+            std::nothrow_t const &) noexcept;
+
+    //! \brief Calls <tt>sink(data, length)</tt> for each datagram of a run returned by receive_segmented().
+
+    template <typename SINK>
+    inline static void for_each_segment(void const * buffer, size_t length, size_t segment_size, SINK sink);
+};
+
+#include "meridian/network/datagram_socket.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__datagram_socket__hpp */
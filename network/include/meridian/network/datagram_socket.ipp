@@ -0,0 +1,21 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename SINK>
+void datagram_socket::for_each_segment(void const * buffer, size_t length, size_t segment_size, SINK sink)
+{
+    char const * data = static_cast<char const *>(buffer);
+
+    if (segment_size == 0) {
+        segment_size = length;
+    }
+
+    // An empty datagram is still a datagram.
+    do {
+        size_t const segment = length < segment_size ? length : segment_size;
+        sink(data, segment);
+        data += segment;
+        length -= segment;
+    } while (length);
+}
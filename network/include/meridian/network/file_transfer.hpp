@@ -0,0 +1,153 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__file_transfer__hpp
+#define meridian__network__file_transfer__hpp
+
+#if defined(__linux__)
+
+#include "meridian/network/io_result.hpp"
+#include "meridian/network/stream_socket.hpp"
+
+#include <sys/types.h>
+#include <vector>
+
+namespace meridian {
+namespace network {
+
+//! \brief A cache of pipes for splicing files to sockets; keep one per reactor.
+//! \class splice_pipe_cache file_transfer.hpp meridian/network/file_transfer.hpp
+//!
+//! \c splice (2) moves data between a file and a socket only by way of a pipe. Creating a pipe per transfer would
+//! cost two descriptors and two system calls each time, so transfers borrow an empty pipe from the cache and give it
+//! back once they've drained it. A pipe still holding data when it's given back belongs to no one and is closed.
+//!
+//! \author Eric Crampton
+
+class splice_pipe_cache {
+public:
+    //! \brief The two ends of a non-blocking pipe.
+    struct splice_pipe {
+        int read_fd;
+        int write_fd;
+    };
+
+    //! \brief Construction.
+    //!
+    //! \param capacity - the most idle pipes to keep open
+
+    explicit splice_pipe_cache(size_t capacity = 4);
+    ~splice_pipe_cache();
+
+    splice_pipe_cache(splice_pipe_cache const & cache) = delete;
+    splice_pipe_cache & operator=(splice_pipe_cache const & cache) = delete;
+
+    //! \brief Sets \a pipe to an empty pipe, cached or new.
+    //!
+    //! \return 0, or the \c errno value if a new pipe couldn't be created
+
+    int acquire(splice_pipe & pipe) noexcept;
+
+    //! \brief Gives \a pipe back; it's kept for reuse if \a empty and there's room, and closed otherwise.
+
+    void release(splice_pipe const & pipe, bool empty) noexcept;
+
+    //! \brief Returns the number of idle pipes held.
+
+    inline size_t size() const noexcept;
+
+private:
+    size_t capacity_;
+    std::vector<splice_pipe> pipes_;
+};
+
+//! \brief Sends part of a file on a non-blocking stream socket, resuming wherever the socket last filled up.
+//! \class file_transfer file_transfer.hpp meridian/network/file_transfer.hpp
+//!
+//! The bytes go from the page cache to the socket without passing through user space: by \c sendfile (2), or, if
+//! the file is one \c sendfile rejects (or method::splice is asked for), by \c splice (2) through a pipe borrowed
+//! from a splice_pipe_cache. Either way the two copies of a \c read and \c send are saved.
+//!
+//! Call send() when the transfer starts and again from the reactor's write callback each time the socket becomes
+//! writable, until done():
+//!
+//! \code
+//! transfer.send(socket, pipes);
+//! if (transfer.done()) { ... }
+//! \endcode
+//!
+//! Each send() moves as much as the socket will take. An error is returned only if nothing could be sent; after
+//! progress, it's left to recur on the next call. A file shorter than the requested length fails with \c ENODATA.
+//!
+//! \author Eric Crampton
+
+class file_transfer {
+public:
+    //! \brief How the bytes are moved.
+    enum class method {
+        sendfile,   //!< \c sendfile (2), falling back to \c splice (2) if the file isn't supported
+        splice      //!< \c splice (2) through a pipe
+    };
+
+    //! \brief Construction.
+    //!
+    //! \param file_fd - the file to send from; it must stay open until the transfer is done or destroyed
+    //! \param offset - where in the file to start
+    //! \param length - the number of bytes to send
+    //! \param how - how to move the bytes
+
+    file_transfer(int file_fd, off_t offset, size_t length, method how = method::sendfile) noexcept;
+    ~file_transfer();
+
+    file_transfer(file_transfer const & transfer) = delete;
+    file_transfer & operator=(file_transfer const & transfer) = delete;
+
+    //! \brief Sends as much of the rest of the file as \a socket will take.
+    //!
+    //! \param socket - the socket to send on, which should be non-blocking
+    //! \param pipes - where to borrow a pipe from, if splicing
+    //!
+    //! \return the number of bytes sent by this call; or an error, which would_block() if the socket was already full
+
+    io_result send(stream_socket & socket, splice_pipe_cache & pipes) noexcept;
+
+    //! \brief Returns true once every byte has been sent.
+
+    inline bool done() const noexcept;
+
+    //! \brief Returns the number of bytes not yet sent.
+
+    inline size_t remaining() const noexcept;
+
+    //! \brief Returns the offset in the file of the next byte to be read from it.
+
+    inline off_t offset() const noexcept;
+
+private:
+    //! \brief The splice() path of send(); \a sent is the number of bytes the caller has sent already.
+
+    io_result splice_to(stream_socket & socket, splice_pipe_cache & pipes, size_t sent) noexcept;
+
+    //! \brief Returns the pipe, if one is borrowed, to its cache.
+
+    void release_pipe() noexcept;
+
+private:
+    int file_fd_;
+    off_t offset_;
+    size_t unread_;                    //!< bytes not yet read from the file
+    size_t buffered_;                  //!< bytes read into the pipe but not yet sent
+    method method_;
+    splice_pipe_cache * pipes_;        //!< the cache \a pipe_ was borrowed from, or null
+    splice_pipe_cache::splice_pipe pipe_;
+};
+
+#include "meridian/network/file_transfer.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__network__file_transfer__hpp */
@@ -0,0 +1,26 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+size_t splice_pipe_cache::size() const noexcept
+{
+    return pipes_.size();
+}
+
+
+bool file_transfer::done() const noexcept
+{
+    return remaining() == 0;
+}
+
+
+size_t file_transfer::remaining() const noexcept
+{
+    return unread_ + buffered_;
+}
+
+
+off_t file_transfer::offset() const noexcept
+{
+    return offset_;
+}
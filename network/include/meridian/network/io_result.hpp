@@ -0,0 +1,64 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__io_result__hpp
+#define meridian__network__io_result__hpp
+
+#include <cerrno>
+#include <cstddef>
+#include <sys/types.h>
+
+namespace meridian {
+namespace network {
+
+//! \brief The outcome of a non-throwing I/O call: a number of bytes, or an \c errno value.
+//! \class io_result io_result.hpp meridian/network/io_result.hpp
+//!
+//! An io_result is a single \c ssize_t, holding the byte count on success and the negated \c errno value on failure,
+//! the same convention as the kernel's own system call returns. It's returned in a register, and checking it is a
+//! compare and a branch, so the non-blocking fast path (where \c EAGAIN is routine) costs no exception.
+//!
+//! \author Eric Crampton
+
+class io_result {
+public:
+    //! \brief Returns a successful result of \a bytes bytes.
+
+    inline static io_result success(size_t bytes) noexcept;
+
+    //! \brief Returns a failed result with the \c errno value \a error.
+
+    inline static io_result failure(int error) noexcept;
+
+    //! \brief Returns true if the call succeeded.
+
+    inline bool ok() const noexcept;
+
+    //! \brief Returns the number of bytes transferred, or 0 if the call failed.
+    //!
+    //! For a receive on a stream socket, 0 bytes with ok() means the peer has performed an orderly shutdown.
+
+    inline size_t bytes() const noexcept;
+
+    //! \brief Returns the \c errno value, or 0 if the call succeeded.
+
+    inline int error() const noexcept;
+
+    //! \brief Returns true if the call failed only because a non-blocking socket wasn't ready.
+
+    inline bool would_block() const noexcept;
+
+private:
+    inline explicit io_result(ssize_t value) noexcept;
+
+private:
+    ssize_t value_;
+};
+
+#include "meridian/network/io_result.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__io_result__hpp */
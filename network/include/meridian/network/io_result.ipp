@@ -0,0 +1,44 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+io_result::io_result(ssize_t value) noexcept
+    : value_(value)
+{
+}
+
+
+io_result io_result::success(size_t bytes) noexcept
+{
+    return io_result(static_cast<ssize_t>(bytes));
+}
+
+
+io_result io_result::failure(int error) noexcept
+{
+    return io_result(-static_cast<ssize_t>(error));
+}
+
+
+bool io_result::ok() const noexcept
+{
+    return value_ >= 0;
+}
+
+
+size_t io_result::bytes() const noexcept
+{
+    return value_ >= 0 ? static_cast<size_t>(value_) : 0;
+}
+
+
+int io_result::error() const noexcept
+{
+    return value_ < 0 ? static_cast<int>(-value_) : 0;
+}
+
+
+bool io_result::would_block() const noexcept
+{
+    return value_ == -EAGAIN || value_ == -EWOULDBLOCK;
+}
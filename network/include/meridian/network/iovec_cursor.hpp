@@ -0,0 +1,70 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__iovec_cursor__hpp
+#define meridian__network__iovec_cursor__hpp
+
+#include <cstddef>
+#include <sys/uio.h>
+
+namespace meridian {
+namespace network {
+
+//! \brief Tracks progress through an array of \c iovec segments across partial transfers.
+//! \class iovec_cursor iovec_cursor.hpp meridian/network/iovec_cursor.hpp
+//!
+//! A vectored send (or receive) may transfer fewer bytes than its segments hold. advance() consumes the bytes which
+//! were transferred: whole segments are skipped, and a partially transferred segment is trimmed in place, so data()
+//! and count() are ready to be passed straight back to the next call. Empty segments are skipped as well, so empty()
+//! becomes true exactly when every byte has been transferred.
+//!
+//! The cursor doesn't own the segments; it modifies the caller's array as it advances.
+//!
+//! \author Eric Crampton
+
+class iovec_cursor {
+public:
+    //! \brief Construction.
+    //!
+    //! \param vectors - the segments, which must outlive the cursor
+    //! \param count - the number of segments
+
+    inline iovec_cursor(iovec * vectors, size_t count) noexcept;
+
+    //! \brief Returns the first segment not yet completely transferred.
+
+    inline iovec * data() const noexcept;
+
+    //! \brief Returns the number of segments not yet completely transferred.
+
+    inline size_t count() const noexcept;
+
+    //! \brief Returns true once every byte has been transferred.
+
+    inline bool empty() const noexcept;
+
+    //! \brief Returns the number of bytes left to transfer. This is O(count()).
+
+    inline size_t bytes() const noexcept;
+
+    //! \brief Consumes \a bytes bytes, which must be no more than bytes().
+
+    inline void advance(size_t bytes) noexcept;
+
+private:
+    //! \brief Skips any empty segments at the front.
+
+    inline void skip_empty() noexcept;
+
+private:
+    iovec * vectors_;
+    size_t count_;
+};
+
+#include "meridian/network/iovec_cursor.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__iovec_cursor__hpp */
@@ -0,0 +1,64 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+iovec_cursor::iovec_cursor(iovec * vectors, size_t count) noexcept
+    : vectors_(vectors)
+    , count_(count)
+{
+    skip_empty();
+}
+
+
+iovec * iovec_cursor::data() const noexcept
+{
+    return vectors_;
+}
+
+
+size_t iovec_cursor::count() const noexcept
+{
+    return count_;
+}
+
+
+bool iovec_cursor::empty() const noexcept
+{
+    return count_ == 0;
+}
+
+
+size_t iovec_cursor::bytes() const noexcept
+{
+    size_t total = 0;
+    for (size_t index = 0; index < count_; ++index) {
+        total += vectors_[index].iov_len;
+    }
+    return total;
+}
+
+
+void iovec_cursor::advance(size_t bytes) noexcept
+{
+    while (count_ && bytes >= vectors_->iov_len) {
+        bytes -= vectors_->iov_len;
+        ++vectors_;
+        --count_;
+    }
+
+    if (count_ && bytes) {
+        vectors_->iov_base = static_cast<char *>(vectors_->iov_base) + bytes;
+        vectors_->iov_len -= bytes;
+    }
+
+    skip_empty();
+}
+
+
+void iovec_cursor::skip_empty() noexcept
+{
+    while (count_ && vectors_->iov_len == 0) {
+        ++vectors_;
+        --count_;
+    }
+}
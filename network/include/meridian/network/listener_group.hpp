@@ -0,0 +1,83 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__listener_group__hpp
+#define meridian__network__listener_group__hpp
+
+#include "meridian/network/socket_address.hpp"
+#include "meridian/network/stream_socket.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace meridian {
+namespace network {
+
+//! \brief A group of listening sockets sharing one address with \c SO_REUSEPORT, typically one per thread.
+//! \class listener_group listener_group.hpp meridian/network/listener_group.hpp
+//!
+//! Every listener is bound to the same address, so the kernel spreads incoming connections across the group. By
+//! default it picks a listener by hashing the connection's addresses and ports, which takes no account of where the
+//! connection's packets are processed: a connection whose receive softirqs run on one core is as likely as not to be
+//! accepted and served by a thread on another, and every packet then crosses cores.
+//!
+//! steer_by_incoming_cpu() replaces the hash with a classic BPF program (\c SO_ATTACH_REUSEPORT_CBPF) which picks
+//! the listener assigned to the CPU that received the connection's SYN. With each listener accepted on a thread
+//! pinned to its CPU, the kernel's receive processing and the connection's handler then share a core. Accepted
+//! sockets report that CPU through socket::get_incoming_cpu().
+//!
+//! Steering only helps when the network card spreads its receive queues across the CPUs the listeners are pinned to
+//! (RSS, or RPS); connections arriving on a CPU with no listener fall back to a listener chosen by CPU number. The
+//! listeners are non-blocking, and are closed on destruction.
+//!
+//! \author Eric Crampton
+
+class listener_group {
+public:
+    //! \brief Creates, binds, and starts \a size listeners.
+    //!
+    //! \param address - the address to bind; if its port is 0, the port chosen for the first listener is used for all
+    //! \param size - the number of listeners
+    //! \param backlog - the listen backlog of each listener
+
+    listener_group(socket_address const & address, size_t size, int backlog);
+
+    //! \brief Destruction; closes the listeners.
+
+    ~listener_group();
+
+    listener_group(listener_group const & group) = delete;
+    listener_group & operator=(listener_group const & group) = delete;
+
+    //! \brief Returns the number of listeners.
+
+    inline size_t size() const;
+
+    //! \brief Returns listener \a index.
+
+    inline stream_socket & at(size_t index);
+
+    //! \brief Returns the address the listeners are bound to.
+
+    socket_address address() const;
+
+    //! \brief Steers each connection to the listener assigned to the CPU which received it.
+    //!
+    //! \param cpus - the CPU assigned to each listener, by index; if a CPU appears more than once, its first listener
+    //! receives its connections
+    //!
+    //! Linux only; throws unsupported_operation_exception elsewhere.
+
+    void steer_by_incoming_cpu(std::vector<int> const & cpus);
+
+private:
+    std::vector<std::unique_ptr<stream_socket>> listeners_;
+};
+
+#include "meridian/network/listener_group.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__listener_group__hpp */
@@ -0,0 +1,14 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+size_t listener_group::size() const
+{
+    return listeners_.size();
+}
+
+
+stream_socket & listener_group::at(size_t index)
+{
+    return *listeners_[index];
+}
@@ -0,0 +1,127 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__receive_buffer_pool__hpp
+#define meridian__network__receive_buffer_pool__hpp
+
+#include <cstddef>
+#include <vector>
+
+namespace meridian {
+namespace network {
+
+//! \brief Receive buffers in power-of-two size classes, recycled rather than freed.
+//! \class receive_buffer_pool receive_buffer_pool.hpp meridian/network/receive_buffer_pool.hpp
+//!
+//! A connection which borrows a buffer only for the duration of a read, as adaptive_receiver does, holds no memory
+//! while idle; with many mostly idle connections, the buffers in use at any moment are few, and a pool keeps them
+//! coming from the same few cache-warm blocks. Sizes run from SMALLEST bytes to SMALLEST << (CLASSES - 1) bytes
+//! (64 KiB); a request is rounded up to its class, so a buffer can be reused for any size in its class. At most
+//! \a max_idle buffers of each class are kept when returned; the rest are freed, so a burst doesn't pin memory.
+//!
+//! The pool isn't thread-safe: keep one per thread, e.g., local(). Every buffer must be returned before the pool is
+//! destroyed.
+//!
+//! \author Eric Crampton
+
+class receive_buffer_pool {
+public:
+    //! \brief The number of size classes.
+    static unsigned const CLASSES = 8;
+
+    //! \brief The size of the smallest class.
+    static size_t const SMALLEST = 512;
+
+    //! \brief A buffer borrowed from a pool; returned to it on destruction.
+    class buffer {
+    public:
+        inline buffer() noexcept;
+        inline buffer(buffer && other) noexcept;
+        inline buffer & operator=(buffer && other) noexcept;
+        inline ~buffer();
+
+        buffer(buffer const & other) = delete;
+        buffer & operator=(buffer const & other) = delete;
+
+        //! \brief Returns the buffer's bytes.
+
+        inline char * data() const noexcept;
+
+        //! \brief Returns the buffer's size, that of its class.
+
+        inline size_t size() const noexcept;
+
+        //! \brief Returns true unless the buffer is empty (default constructed or moved from).
+
+        inline explicit operator bool() const noexcept;
+
+        //! \brief Returns the buffer to its pool, leaving it empty.
+
+        inline void reset() noexcept;
+
+    private:
+        friend class receive_buffer_pool;
+
+        inline buffer(receive_buffer_pool * pool, char * data, unsigned size_class) noexcept;
+
+    private:
+        receive_buffer_pool * pool_;
+        char * data_;
+        unsigned size_class_;
+    };
+
+    //! \brief Construction.
+    //!
+    //! \param max_idle - the most returned buffers of each class to keep for reuse
+
+    explicit receive_buffer_pool(size_t max_idle = 16);
+
+    //! \brief Destruction; frees the idle buffers. Every buffer must have been returned.
+
+    ~receive_buffer_pool();
+
+    receive_buffer_pool(receive_buffer_pool const & pool) = delete;
+    receive_buffer_pool & operator=(receive_buffer_pool const & pool) = delete;
+
+    //! \brief Returns this thread's pool.
+
+    static receive_buffer_pool & local();
+
+    //! \brief Returns the smallest class holding \a size bytes; the largest class if none does.
+
+    inline static unsigned size_class(size_t size) noexcept;
+
+    //! \brief Returns the size of buffers of class \a size_class.
+
+    inline static size_t class_size(unsigned size_class) noexcept;
+
+    //! \brief Borrows a buffer of at least \a size bytes (at most the largest class), reusing an idle one if possible.
+
+    buffer acquire(size_t size);
+
+    //! \brief Returns the number of buffers held for reuse.
+
+    size_t idle() const noexcept;
+
+    //! \brief Returns the number of buffers borrowed and not yet returned.
+
+    inline size_t outstanding() const noexcept;
+
+private:
+    //! \brief Takes back a buffer's bytes.
+
+    void release(char * data, unsigned size_class) noexcept;
+
+private:
+    size_t const max_idle_;
+    std::vector<char *> idle_[CLASSES];
+    size_t outstanding_;
+};
+
+#include "meridian/network/receive_buffer_pool.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* meridian__network__receive_buffer_pool__hpp */
@@ -0,0 +1,100 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+receive_buffer_pool::buffer::buffer() noexcept
+    : pool_(nullptr)
+    , data_(nullptr)
+    , size_class_(0)
+{
+}
+
+
+receive_buffer_pool::buffer::buffer(receive_buffer_pool * pool, char * data, unsigned size_class) noexcept
+    : pool_(pool)
+    , data_(data)
+    , size_class_(size_class)
+{
+}
+
+
+receive_buffer_pool::buffer::buffer(buffer && other) noexcept
+    : pool_(other.pool_)
+    , data_(other.data_)
+    , size_class_(other.size_class_)
+{
+    other.pool_ = nullptr;
+    other.data_ = nullptr;
+}
+
+
+receive_buffer_pool::buffer & receive_buffer_pool::buffer::operator=(buffer && other) noexcept
+{
+    if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        data_ = other.data_;
+        size_class_ = other.size_class_;
+        other.pool_ = nullptr;
+        other.data_ = nullptr;
+    }
+
+    return *this;
+}
+
+
+receive_buffer_pool::buffer::~buffer()
+{
+    reset();
+}
+
+
+char * receive_buffer_pool::buffer::data() const noexcept
+{
+    return data_;
+}
+
+
+size_t receive_buffer_pool::buffer::size() const noexcept
+{
+    return data_ ? class_size(size_class_) : 0;
+}
+
+
+receive_buffer_pool::buffer::operator bool() const noexcept
+{
+    return data_ != nullptr;
+}
+
+
+void receive_buffer_pool::buffer::reset() noexcept
+{
+    if (data_) {
+        pool_->release(data_, size_class_);
+        pool_ = nullptr;
+        data_ = nullptr;
+    }
+}
+
+
+unsigned receive_buffer_pool::size_class(size_t size) noexcept
+{
+    unsigned size_class = 0;
+    while (size_class + 1 < CLASSES && class_size(size_class) < size) {
+        ++size_class;
+    }
+
+    return size_class;
+}
+
+
+size_t receive_buffer_pool::class_size(unsigned size_class) noexcept
+{
+    return SMALLEST << size_class;
+}
+
+
+size_t receive_buffer_pool::outstanding() const noexcept
+{
+    return outstanding_;
+}
@@ -0,0 +1,228 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__sharded_runtime__hpp
+#define meridian__network__sharded_runtime__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/delegate.hpp"
+#include "meridian/network/listener_group.hpp"
+#include "meridian/network/socket_address.hpp"
+#include "meridian/network/stream_socket.hpp"
+#include "meridian/reactor/epoll_reactor.hpp"
+#include "meridian/reactor/spsc_channel.hpp"
+#include "meridian/reactor/wakeup_source.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace meridian {
+namespace network {
+
+//! \brief A thread-per-core runtime: one reactor per thread, each thread pinned to its own CPU.
+//! \class sharded_runtime sharded_runtime.hpp meridian/network/sharded_runtime.hpp
+//!
+//! The runtime is split into shards. Each shard owns a reactor (with its own dense registry), runs it on a thread of
+//! its own pinned to one of the CPUs the process may run on, and never touches another shard's reactor. Nothing is
+//! shared between shards on the I/O path, so throughput scales with the number of cores.
+//!
+//! listen() gives every shard its own listening socket, from a listener_group bound to the same address with
+//! \c SO_REUSEPORT. Each connection is accepted, and then served, by a single shard: accepts never cross threads. When
+//! every shard has a CPU of its own, the group steers each connection to the shard pinned to the CPU which received
+//! it, so the kernel's receive processing and the connection's handler share a core. Connections are accepted with
+//! stream_socket::accept_batch() into the shard's own socket pool, so accepting allocates nothing in the steady
+//! state. If accepting fails, e.g., because the process has run out of file descriptors, the shard stops accepting
+//! for a short while, leaving the pending connections queued, and carries on serving those it has.
+//!
+//! Work crosses shards only through submit_to(). Between every ordered pair of shards there's an spsc_channel; a
+//! submission from one shard to another is a push onto that channel plus, if the target isn't already due to look at
+//! its channels, a single \c eventfd wakeup. Submissions from threads which aren't shards go through the target
+//! reactor's post() instead.
+//!
+//! The runtime uses epoll_reactor, and so is only available on Linux. An exception escaping a callback on a shard
+//! thread terminates the process.
+//!
+//! \author Eric Crampton
+
+class sharded_runtime {
+public:
+    //! \brief The reactor each shard runs.
+    typedef reactor::epoll_reactor reactor_type;
+
+    //! \brief Function type of work submitted with submit_to().
+    typedef core::delegate<void ()> task;
+
+    class shard;
+
+    //! \brief Called on a shard's thread for each connection its listener accepts.
+    //!
+    //! The same handler is called by every shard, concurrently. The connection is non-blocking and close-on-exec. It
+    //! lives in the accepting shard's socket pool, so its handle must be released on that shard's thread, before the
+    //! runtime is destroyed.
+    typedef core::delegate<void (shard &, stream_socket::pool::handle, socket_address const &)> connection_handler;
+
+    //! \brief Called once on each shard's thread before it starts waiting for events.
+    typedef core::delegate<void (shard &)> shard_function;
+
+    //! \brief One thread of the runtime, with its reactor and listener.
+
+    class shard {
+    public:
+        shard(shard const & other) = delete;
+        shard & operator=(shard const & other) = delete;
+
+        //! \brief Returns this shard's index, from 0 to sharded_runtime::size() - 1.
+
+        inline size_t index() const;
+
+        //! \brief Returns the CPU this shard's thread is pinned to.
+
+        inline int cpu() const;
+
+        //! \brief Returns this shard's reactor. Only to be used from this shard's thread, except for post().
+
+        inline reactor_type & reactor();
+
+        //! \brief Returns this shard's listening socket, or nullptr if sharded_runtime::listen() hasn't been called.
+
+        inline stream_socket * listener();
+
+        //! \brief Returns the runtime this shard belongs to.
+
+        inline sharded_runtime & runtime();
+
+    private:
+        friend class sharded_runtime;
+
+        shard(sharded_runtime & runtime, size_t index, int cpu);
+
+    private:
+        sharded_runtime & runtime_;
+        size_t const index_;
+        int const cpu_;
+        reactor::wakeup_source wakeup_;          //!< readable when another shard has pushed onto a channel to this one
+        std::atomic<bool> notified_;             //!< true if wakeup_ has been notified since the channels were drained
+        stream_socket::pool sockets_;            //!< accepted connections; declared first, to outlive reactor_
+        reactor_type reactor_;
+    };
+
+    //! \brief Construction.
+    //!
+    //! \param shards - the number of shards; 0 means one per CPU the process may run on
+    //! \param channel_capacity - the capacity of each channel between two shards
+    //!
+    //! No threads are started until start().
+
+    explicit sharded_runtime(size_t shards = 0, size_t channel_capacity = 1024);
+
+    //! \brief Destruction; stops the runtime and waits for its threads. Must not be called from a shard's thread.
+
+    ~sharded_runtime();
+
+    sharded_runtime(sharded_runtime const & runtime) = delete;
+    sharded_runtime & operator=(sharded_runtime const & runtime) = delete;
+
+    //! \brief Returns the number of shards.
+
+    inline size_t size() const;
+
+    //! \brief Returns shard \a index.
+
+    inline shard & at(size_t index);
+
+    //! \brief Returns the shard running on the calling thread, or nullptr if it isn't one of this runtime's threads.
+
+    shard * current();
+
+    //! \brief Gives every shard a listening socket bound to \a address with \c SO_REUSEPORT. Call before start().
+    //!
+    //! \param address - the address to bind; if its port is 0, the port chosen for the first shard is used for all
+    //! \param backlog - the listen backlog of each shard's socket
+    //! \param handler - called on the accepting shard's thread with each connection
+    //!
+    //! If no two shards share a CPU, connections are steered to shards by incoming CPU (see listener_group).
+
+    void listen(socket_address const & address, int backlog, connection_handler handler);
+
+    //! \brief Returns the address the listeners are bound to.
+
+    socket_address listen_address() const;
+
+    //! \brief Starts one thread per shard, pinned to the shard's CPU.
+    //!
+    //! \param init - if set, called on each shard's thread before its reactor starts waiting
+    //!
+    //! Each thread pins itself before touching its shard, and no shard runs until every thread has been pinned. If
+    //! any can't be, the threads are stopped and joined before the error is thrown.
+
+    void start(shard_function init = nullptr);
+
+    //! \brief Runs \a function on shard \a target's thread. May be called from any thread.
+    //!
+    //! Tasks submitted from one thread to one shard run in the order they were submitted.
+
+    void submit_to(size_t target, task function);
+
+    //! \brief Asks every shard to stop once its current wait_for_events() returns. May be called from any thread.
+
+    void stop();
+
+    //! \brief Waits for every shard's thread to finish. Must not be called from a shard's thread.
+
+    void join();
+
+private:
+    //! \brief The channel from one shard to another.
+    struct channel {
+        explicit channel(size_t capacity);
+
+        reactor::spsc_channel<task> tasks;
+
+        //! \brief The number of tasks submitted through the target's post() because \a tasks was full.
+        //!
+        //! While it's non-zero, further tasks are posted too, so they don't overtake those already posted.
+        std::atomic<size_t> overflowed;
+    };
+
+    class overflow_task;
+    class startup_barrier;
+
+    inline channel & channel_between(size_t from, size_t to);
+
+    //! \brief The body of a shard's thread.
+
+    void run(shard & self, shard_function const & init);
+
+    //! \brief Called on a shard's thread when its listener is readable.
+
+    void accept_connections(shard & self);
+
+    //! \brief Called on a shard's thread when its wakeup_source is readable.
+
+    void on_wakeup(shard & self);
+
+    //! \brief Runs every task in the channel from shard \a from to shard \a to, on shard \a to's thread.
+
+    void drain(size_t from, size_t to);
+
+private:
+    std::vector<std::unique_ptr<shard>> shards_;
+    std::vector<std::unique_ptr<channel>> channels_;   //!< channel from shard \c f to shard \c t at f * size() + t
+    std::unique_ptr<listener_group> listeners_;
+    connection_handler on_connection_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_;
+};
+
+#include "meridian/network/sharded_runtime.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__network__sharded_runtime__hpp */
@@ -0,0 +1,50 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+size_t sharded_runtime::shard::index() const
+{
+    return index_;
+}
+
+
+int sharded_runtime::shard::cpu() const
+{
+    return cpu_;
+}
+
+
+sharded_runtime::reactor_type & sharded_runtime::shard::reactor()
+{
+    return reactor_;
+}
+
+
+stream_socket * sharded_runtime::shard::listener()
+{
+    return runtime_.listeners_ ? &runtime_.listeners_->at(index_) : nullptr;
+}
+
+
+sharded_runtime & sharded_runtime::shard::runtime()
+{
+    return runtime_;
+}
+
+
+size_t sharded_runtime::size() const
+{
+    return shards_.size();
+}
+
+
+sharded_runtime::shard & sharded_runtime::at(size_t index)
+{
+    return *shards_[index];
+}
+
+
+sharded_runtime::channel & sharded_runtime::channel_between(size_t from, size_t to)
+{
+    return *channels_[from * shards_.size() + to];
+}
@@ -6,10 +6,15 @@
 #define meridian__network__socket__hpp
 
 #include "meridian/core/event_source.hpp"
+#include "meridian/network/io_result.hpp"
+#include "meridian/network/iovec_cursor.hpp"
 #include "meridian/network/ip_address.hpp"
 #include "meridian/network/socket_address.hpp"
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <new>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace meridian {
@@ -67,6 +72,14 @@ public:
     void set_reuse_address(bool flag);
     bool get_reuse_address() const;
 
+    //! \brief Sets or clears \c SO_REUSEPORT.
+    //!
+    //! \param flag - true to allow other sockets with the option set to bind the same address and port
+    //!
+    //! On Linux, the kernel spreads incoming connections (or datagrams) across all listening sockets bound with the
+    //! option, so each thread of a server may accept on a socket of its own. Throws unsupported_operation_exception
+    //! on systems without \c SO_REUSEPORT.
+
     void set_reuse_port(bool flag);
     bool get_reuse_port() const;
 
@@ -75,12 +88,32 @@ public:
 
     void set_broadcast(bool flag);
     bool get_broadcast() const;
+
+    //! \brief Returns the CPU on which the kernel processed the socket's most recent incoming packets
+    //! (\c SO_INCOMING_CPU), or -1 if none has arrived.
+    //!
+    //! For a connection accepted from a listener_group which steers by CPU, this is the CPU the connection was
+    //! steered for. Linux only; throws unsupported_operation_exception elsewhere.
+
+    int get_incoming_cpu() const;
+
+    //! \brief Sets or clears \c O_NONBLOCK on the socket's file descriptor.
+    //!
+    //! \param flag - true to make I/O on this socket non-blocking
+
+    void set_non_blocking(bool flag);
+    bool get_non_blocking() const;
     
     //! \brief Returns the number of bytes which can be read without blocking.
     //!
     //! \return number of bytes available; 0 if no data is available
 
     int available();
+
+    //! \brief Returns the number of bytes which can be read without blocking, as the io_result's byte count, without
+    //! throwing.
+
+    io_result available(std::nothrow_t const &) noexcept;
     
     socket_address address() const;
     socket_address peer_address() const;
@@ -92,10 +125,91 @@ protected:
     void init(socket_domain domain, int type, int proto = 0);
     
     //! \brief Receive bytes on this socket.
+    //!
+    //! This and the other throwing I/O functions are thin wrappers over the \c std::nothrow overloads below: they
+    //! retry on \c EINTR and throw any other error, including \c EAGAIN.
     ssize_t receive(void * buffer, size_t length, int flags);
     ssize_t send(void const * buffer, size_t length, int flags);
     ssize_t receive_from(void * buffer, size_t length, int flags, socket_address & address);
     ssize_t send_to(void const * buffer, size_t length, int flags, socket_address const & address);
+
+    //! \brief Receives into the \a count segments at \a vectors, in order (scatter).
+    //!
+    //! At most \c IOV_MAX segments are used per call.
+    ssize_t receive_vectored(iovec const * vectors, size_t count, int flags);
+
+    //! \brief Sends the \a count segments at \a vectors as one contiguous run of bytes (gather).
+    //!
+    //! This saves copying separately built pieces (e.g., header, body, and trailer) into one buffer, and a system call
+    //! per piece. At most \c IOV_MAX segments are used per call.
+    ssize_t send_vectored(iovec const * vectors, size_t count, int flags);
+
+    //! \brief Sends the remaining segments of \a cursor and advances it past the bytes sent.
+    //!
+    //! A stream socket may accept fewer bytes than were offered; call again with the same cursor, once the socket is
+    //! writable, until it's empty().
+    ssize_t send_vectored(iovec_cursor & cursor, int flags);
+
+    //! \brief Receives into the remaining segments of \a cursor and advances it past the bytes received.
+    ssize_t receive_vectored(iovec_cursor & cursor, int flags);
+
+    //! \brief Receives a message (\c recvmsg (2)), including any ancillary data requested through
+    //! \c msg_control.
+    //!
+    //! On return the kernel has updated \c msg_controllen, \c msg_namelen, and \c msg_flags.
+    ssize_t receive_message(msghdr & message, int flags);
+
+    //! \brief Sends a message (\c sendmsg (2)), including any ancillary data in \c msg_control (e.g.,
+    //! \c SCM_RIGHTS).
+    ssize_t send_message(msghdr const & message, int flags);
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Non-throwing I/O
+    //!
+    //! These report failure in the returned io_result instead of throwing, so that the routine \c EAGAIN of a
+    //! non-blocking socket is a branch rather than an exception. \c EINTR is retried. An invalid socket yields
+    //! \c EBADF.
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Receives bytes on this socket (\c recv (2)).
+    io_result receive(void * buffer, size_t length, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Sends bytes on this socket (\c send (2)).
+    io_result send(void const * buffer, size_t length, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Receives a datagram and its sender's address (\c recvfrom (2)); \a address is only set on success.
+    io_result receive_from(
+            void * buffer,
+            size_t length,
+            int flags,
+            socket_address & address,
+            std::nothrow_t const &) noexcept;
+
+    //! \brief Sends a datagram to \a address (\c sendto (2)).
+    io_result send_to(
+            void const * buffer,
+            size_t length,
+            int flags,
+            socket_address const & address,
+            std::nothrow_t const &) noexcept;
+
+    //! \brief Receives into the \a count segments at \a vectors (\c recvmsg (2)).
+    io_result receive_vectored(iovec const * vectors, size_t count, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Sends the \a count segments at \a vectors (\c sendmsg (2)).
+    io_result send_vectored(iovec const * vectors, size_t count, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Sends the remaining segments of \a cursor, advancing it on success.
+    io_result send_vectored(iovec_cursor & cursor, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Receives into the remaining segments of \a cursor, advancing it on success.
+    io_result receive_vectored(iovec_cursor & cursor, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Receives a message and its ancillary data (\c recvmsg (2)).
+    io_result receive_message(msghdr & message, int flags, std::nothrow_t const &) noexcept;
+
+    //! \brief Sends a message and its ancillary data (\c sendmsg (2)).
+    io_result send_message(msghdr const & message, int flags, std::nothrow_t const &) noexcept;
     
     void bind(socket_address const & address);
     void listen(int backlog);
@@ -103,15 +217,8 @@ protected:
     void shutdown_send();
     void shutdown();
     void shutdown(int how);
-    
-    inline int fd();
-    
-private:
-    int fd_;
 };
 
-#include "meridian/network/socket.ipp"
-
 } // namespace network
 } // namespace meridian
 
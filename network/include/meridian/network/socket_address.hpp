@@ -30,7 +30,9 @@ public:
     //! \name Construction, move construction, assignment
     //////////////////////////////////////////////////////////////////////////////////
 
-    socket_address() { }
+    //! \brief Constructs an empty socket address, of length 0.
+
+    socket_address() : addr_{ }, length_{ 0 } { }
     
     //! \brief Creates a socket address from a @c sockaddr pointer and length.
     //!
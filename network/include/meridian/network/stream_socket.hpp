@@ -5,14 +5,42 @@
 #ifndef meridian__network__stream_socket__hpp
 #define meridian__network__stream_socket__hpp
 
+#include "meridian/core/object_pool.hpp"
+#include "meridian/network/exception.hpp"
 #include "meridian/network/socket.hpp"
 #include "meridian/network/socket_domain.hpp"
 
+#include <cerrno>
+#include <fcntl.h>
+#include <functional>
 #include <memory>
+#include <sys/socket.h>
+
+#if defined(__linux__)
+#include "meridian/reactor/io_uring_buffer_group.hpp"
+#include "meridian/reactor/io_uring_reactor.hpp"
+#endif
 
 namespace meridian {
 namespace network {
 
+//! \brief Why a drain loop (e.g., stream_socket::receive_until_drained()) stopped.
+
+enum class drain_status : std::uint8_t {
+    drained,          //!< the socket returned \c EAGAIN; an edge-triggered reactor will report it again when ready
+    budget_exhausted, //!< the budget ran out first; the socket may still be ready and must be re-armed
+    closed,           //!< the peer performed an orderly shutdown (receive only)
+    failed            //!< an error occurred; see drain_result::error (only for loops which don't throw)
+};
+
+//! \brief Result of a drain loop: why it stopped, and how much it did (bytes received or sockets accepted).
+
+struct drain_result {
+    drain_status status;
+    size_t count;
+    int error;        //!< the \c errno value if \a status is drain_status::failed; otherwise 0
+};
+
 //! \brief A stream socket providing a reliable, bidirectional, byte-oriented communication channel.
 //! \class stream_socket stream_socket.hpp meridian/network/stream_socket.hpp
 //! 
@@ -22,15 +50,181 @@ public:
     using socket::bind;
     using socket::listen;
     using socket::send;
+    using socket::send_vectored;
+    using socket::receive_vectored;
+    using socket::send_message;
+    using socket::receive_message;
+    using socket::shutdown;
+    using socket::shutdown_receive;
+    using socket::shutdown_send;
+
+    //! \brief A pool to allocate accepted stream_sockets from; keep one per thread.
+    typedef core::object_pool<stream_socket> pool;
 
     explicit stream_socket(socket_domain domain, int protocol = 0);
     explicit stream_socket(int fd) : socket(fd) { }
     std::unique_ptr<stream_socket> accept(socket_address & address);
+
+    //! \brief Accepts a connection into a slot of \a sockets rather than a fresh heap allocation.
+    //!
+    //! \param address - receives the peer's address
+    //! \param sockets - the pool to construct the accepted socket in
+    //!
+    //! \return a handle which returns the socket to \a sockets when released
+
+    pool::handle accept(socket_address & address, pool & sockets);
+
+    //! \brief Receives repeatedly until the socket would block, the peer closes, or the budget is spent.
+    //!
+    //! \param buffer - scratch buffer each read lands in
+    //! \param length - size of \a buffer
+    //! \param budget - maximum number of bytes to receive in this call
+    //! \param sink - called as <tt>sink(buffer, bytes)</tt> after each successful read
+    //!
+    //! This is meant for non-blocking sockets registered in edge-triggered mode. Unlike receive(), \c EAGAIN isn't an
+    //! error: it ends the loop with drain_status::drained. A short read doesn't end the loop: the peer may have closed
+    //! right after its last data, and an edge-triggered reactor reports that only once, so the loop keeps reading until
+    //! \c EAGAIN or end-of-file. Any other error is thrown as usual.
+    //!
+    //! \return the reason the loop stopped and the number of bytes received
+
+    template <typename SINK>
+    drain_result receive_until_drained(void * buffer, size_t length, size_t budget, SINK sink);
+
+    //! \brief Accepts connections until the listening socket would block or \a max connections were accepted.
+    //!
+    //! \param max - maximum number of connections to accept in this call
+    //! \param sink - called as <tt>sink(std::unique_ptr<stream_socket>, socket_address const &)</tt> per connection
+    //!
+    //! The listening socket should be non-blocking. This is accept_batch() with each connection wrapped in a
+    //! stream_socket, so each is accepted non-blocking and close-on-exec, ready for receive_until_drained(), and
+    //! connections which fail before they can be accepted are skipped. Any other error is thrown.
+    //!
+    //! \return drain_status::drained or drain_status::budget_exhausted, and the number of connections accepted
+
+    template <typename SINK>
+    drain_result accept_until_drained(size_t max, SINK sink);
+
+    //! \brief Like accept_until_drained(size_t, SINK), but constructs each connection in a slot of \a sockets.
+    //!
+    //! \a sink is called as <tt>sink(stream_socket::pool::handle, socket_address const &)</tt>.
+
+    template <typename SINK>
+    drain_result accept_until_drained(size_t max, pool & sockets, SINK sink);
+
+    //! \brief Accepts connections as raw descriptors until the listening socket would block or \a max were accepted.
+    //!
+    //! \param max - maximum number of connections to accept in this call
+    //! \param sink - called as <tt>sink(int fd, sockaddr const * address, socklen_t length)</tt> per connection, and
+    //! takes ownership of \a fd
+    //!
+    //! This is the loop behind accept_until_drained(), for connection storms: each connection is accepted with
+    //! \c accept4 (2), already non-blocking and close-on-exec, so there's no \c fcntl per connection; no stream_socket
+    //! is allocated, so the sink may wrap the descriptor however it likes (or refuse it); and nothing is thrown.
+    //! Connections which fail before they can be accepted are skipped. Any other error, such as running out of file
+    //! descriptors (\c EMFILE), ends the loop with drain_status::failed, leaving the remaining connections queued for
+    //! the caller to retry once it has backed off.
+    //!
+    //! \return the reason the loop stopped, the number of connections accepted, and the error, if any
+
+    template <typename SINK>
+    drain_result accept_batch(size_t max, SINK sink);
+
+#if defined(__linux__)
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Completion-based (proactor) I/O
+    //!
+    //! These start an operation which the kernel performs on its own; the handler is called from the reactor's
+    //! wait_for_events() once it's done, so a receive costs no readiness wakeup and no separate \c recv. Errors are
+    //! passed to the handler as an \c errno value (0 on success) rather than thrown. The socket, and any buffer
+    //! passed in, must stay valid until the handler has been called; shutdown() completes pending operations.
+    //!
+    //! Completion-based operations may be mixed freely with readiness callbacks registered on the same reactor.
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Handler for async_receive() and async_send(): <tt>handler(error, bytes)</tt>.
+    typedef std::function<void (int, size_t)> completion_handler;
+
+    //! \brief Handler for async_receive() into a provided buffer: <tt>handler(error, data, bytes)</tt>.
+    //!
+    //! \a data is only valid during the call; the buffer is returned to its group afterward.
+    typedef std::function<void (int, char const *, size_t)> provided_buffer_handler;
+
+    //! \brief Handler for async_accept(): <tt>handler(error, socket, address)</tt>.
+    //!
+    //! On error, \a socket is empty and \a address is unspecified.
+    typedef std::function<void (int, std::unique_ptr<stream_socket>, socket_address const &)> accept_handler;
+
+    //! \brief Receives into a caller-supplied buffer.
+    //!
+    //! \param reactor - the reactor performing the operation
+    //! \param buffer - destination buffer
+    //! \param length - size of \a buffer
+    //! \param handler - called with the number of bytes received (0 if the peer closed the connection)
+
+    void async_receive(reactor::io_uring_reactor & reactor, void * buffer, size_t length, completion_handler handler);
+
+    //! \brief Receives into a buffer chosen by the kernel from \a buffers when data arrives.
+    //!
+    //! \param reactor - the reactor performing the operation; \a buffers must be registered with it
+    //! \param buffers - the provided-buffer group to receive into
+    //! \param handler - called with the received data
+
+    void async_receive(
+            reactor::io_uring_reactor & reactor,
+            reactor::io_uring_buffer_group & buffers,
+            provided_buffer_handler handler);
+
+    //! \brief Sends from a caller-supplied buffer.
+    //!
+    //! \param reactor - the reactor performing the operation
+    //! \param buffer - data to send
+    //! \param length - number of bytes in \a buffer
+    //! \param handler - called with the number of bytes sent, which may be fewer than \a length
+
+    void async_send(reactor::io_uring_reactor & reactor, void const * buffer, size_t length, completion_handler handler);
+
+    //! \brief Accepts one connection.
+    //!
+    //! \param reactor - the reactor performing the operation
+    //! \param handler - called with the accepted connection, which, as with accept_batch(), is non-blocking and
+    //! close-on-exec
+
+    void async_accept(reactor::io_uring_reactor & reactor, accept_handler handler);
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //! \name Zero-copy file transmission
+    //////////////////////////////////////////////////////////////////////////////////
+
+    //! \brief Sends up to \a length bytes of a file without copying them through user space (\c sendfile (2)).
+    //!
+    //! \param file_fd - the file to send from
+    //! \param offset - where in the file to start; advanced past the bytes sent
+    //! \param length - the most bytes to send
+    //!
+    //! \return the number of bytes sent, which may be fewer than \a length; 0 at the end of the file
+    //!
+    //! To send a whole file from a non-blocking socket, resuming from the reactor's write callback, and falling back
+    //! to \c splice (2) for files \c sendfile won't take, see file_transfer.
+
+    size_t send_file(int file_fd, off_t & offset, size_t length);
+
+    //! \brief Sends part of a file without throwing.
+
+    io_result send_file(int file_fd, off_t & offset, size_t length, std::nothrow_t const &) noexcept;
+#endif
+
+private:
+    //! \brief The body of accept_until_drained(): runs accept_batch(), wrapping each descriptor with \a make before
+    //! passing it to \a sink, and throws if it fails.
+
+    template <typename MAKE, typename SINK>
+    drain_result accept_loop(size_t max, MAKE make, SINK sink);
 };
 
+#include "meridian/network/stream_socket.ipp"
+
 } // namespace network
 } // namespace meridian
 
 #endif /* meridian__network__stream_socket__hpp */
-
-         
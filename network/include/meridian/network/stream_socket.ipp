@@ -0,0 +1,144 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename SINK>
+drain_result stream_socket::receive_until_drained(void * buffer, size_t length, size_t budget, SINK sink)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    size_t total = 0;
+    while (total < budget) {
+        size_t const request = std::min(length, budget - total);
+        io_result const result = receive(buffer, request, 0, std::nothrow);
+
+        if (!result.ok()) {
+            if (result.would_block()) {
+                return drain_result{ drain_status::drained, total, 0 };
+            }
+
+            throw exception()
+                << boost::errinfo_errno(result.error())
+                << boost::errinfo_api_function("recv");
+        }
+
+        if (result.bytes() == 0) {
+            return drain_result{ drain_status::closed, total, 0 };
+        }
+
+        total += result.bytes();
+        sink(static_cast<void const *>(buffer), result.bytes());
+    }
+
+    return drain_result{ drain_status::budget_exhausted, total, 0 };
+}
+
+
+template <typename SINK>
+drain_result stream_socket::accept_until_drained(size_t max, SINK sink)
+{
+    return accept_loop(max, [](int fd) { return std::unique_ptr<stream_socket>(new stream_socket(fd)); }, sink);
+}
+
+
+template <typename SINK>
+drain_result stream_socket::accept_until_drained(size_t max, pool & sockets, SINK sink)
+{
+    return accept_loop(max, [&sockets](int fd) { return sockets.make(fd); }, sink);
+}
+
+
+template <typename MAKE, typename SINK>
+drain_result stream_socket::accept_loop(size_t max, MAKE make, SINK sink)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    drain_result const result = accept_batch(
+            max,
+            [&make, &sink](int accept_fd, sockaddr const * address, socklen_t length) {
+                decltype(make(accept_fd)) accepted_socket;
+                try {
+                    accepted_socket = make(accept_fd);
+                }
+                catch (...) {
+                    ::close(accept_fd);
+                    throw;
+                }
+
+                sink(std::move(accepted_socket), socket_address(const_cast<sockaddr *>(address), length));
+            });
+
+    if (result.status == drain_status::failed) {
+        throw exception()
+            << boost::errinfo_errno(result.error)
+            << boost::errinfo_api_function("accept4");
+    }
+
+    return result;
+}
+
+
+template <typename SINK>
+drain_result stream_socket::accept_batch(size_t max, SINK sink)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return drain_result{ drain_status::failed, 0, EBADF };
+    }
+
+    size_t accepted = 0;
+    while (accepted < max) {
+        sockaddr_storage addr;
+        socklen_t addr_length = sizeof(addr);
+
+#if defined(__linux__) || defined(__FreeBSD__)
+        int accept_fd = ::accept4(
+                fd(), reinterpret_cast<sockaddr *>(&addr), &addr_length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        int accept_fd = ::accept(fd(), reinterpret_cast<sockaddr *>(&addr), &addr_length);
+        if (accept_fd >= 0
+            && (::fcntl(accept_fd, F_SETFL, O_NONBLOCK) < 0 || ::fcntl(accept_fd, F_SETFD, FD_CLOEXEC) < 0)) {
+            int const error = errno;
+            ::close(accept_fd);
+            return drain_result{ drain_status::failed, accepted, error };
+        }
+#endif
+
+        if (accept_fd < 0) {
+            switch (errno) {
+                case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+                case EWOULDBLOCK:
+#endif
+                    return drain_result{ drain_status::drained, accepted, 0 };
+
+                // The connection failed before it could be accepted (on Linux, errors pending on it are reported
+                // here too); move on to the next one.
+                case EINTR:
+                case ECONNABORTED:
+                case EPROTO:
+                case ENOPROTOOPT:
+                case EHOSTDOWN:
+                case EHOSTUNREACH:
+                case ENETDOWN:
+                case ENETUNREACH:
+                case EOPNOTSUPP:
+#if defined(ENONET)
+                case ENONET:
+#endif
+                    continue;
+
+                default:
+                    return drain_result{ drain_status::failed, accepted, errno };
+            }
+        }
+
+        ++accepted;
+        sink(accept_fd, reinterpret_cast<sockaddr const *>(&addr), addr_length);
+    }
+
+    return drain_result{ drain_status::budget_exhausted, accepted, 0 };
+}
@@ -0,0 +1,120 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__network__zerocopy_sender__hpp
+#define meridian__network__zerocopy_sender__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/delegate.hpp"
+#include "meridian/network/io_result.hpp"
+#include "meridian/network/stream_socket.hpp"
+
+#include <cstdint>
+#include <deque>
+
+namespace meridian {
+namespace network {
+
+//! \brief Sends large buffers on a stream socket with \c MSG_ZEROCOPY, telling the caller when each may be reused.
+//! \class zerocopy_sender zerocopy_sender.hpp meridian/network/zerocopy_sender.hpp
+//!
+//! With \c MSG_ZEROCOPY, \c send (2) pins the caller's pages and the NIC reads them directly, saving the copy into
+//! the kernel; but the buffer may not be touched until the kernel says it's done with it. It says so on the socket's
+//! error queue: each zero-copy send is numbered, and a notification covers a range of those numbers, possibly many
+//! sends at once. The notification also says whether the kernel had to copy after all (\c
+//! SO_EE_CODE_ZEROCOPY_COPIED), as it does for loopback and devices without scatter-gather, in which case zero-copy
+//! is only overhead for that socket.
+//!
+//! send() takes a completion with each buffer, and reap() reads the error queue and calls the completions whose
+//! sends the kernel has released, in the order the buffers were sent, so a pooled buffer may go back to its pool from
+//! its completion. A pending notification makes the socket report an error condition (\c EPOLLERR), which every
+//! reactor passes to both the read and the write callback; call reap() from whichever the socket has registered.
+//!
+//! Copying is cheaper than pinning for small buffers, so buffers under THRESHOLD bytes are sent normally, as are all
+//! buffers if the socket doesn't support \c SO_ZEROCOPY or the kernel is short of memory for notifications
+//! (\c ENOBUFS). Their completions report a copy, and are called as soon as every earlier completion has been.
+//!
+//! The sender must be destroyed before the socket is closed.
+//!
+//! \author Eric Crampton
+
+class zerocopy_sender {
+public:
+    //! \brief Called once the kernel no longer needs a buffer: <tt>on_complete(copied)</tt>, where \a copied is true
+    //! if any of it was copied rather than sent from the caller's pages.
+    typedef core::delegate<void (bool)> completion;
+
+    //! \brief The smallest buffer sent with \c MSG_ZEROCOPY.
+    static size_t const THRESHOLD = 16 * 1024;
+
+    //! \brief Construction; enables \c SO_ZEROCOPY on \a socket if it's supported.
+
+    explicit zerocopy_sender(stream_socket & socket);
+
+    zerocopy_sender(zerocopy_sender const & sender) = delete;
+    zerocopy_sender & operator=(zerocopy_sender const & sender) = delete;
+
+    //! \brief Sends as much of \a buffer as the socket will take.
+    //!
+    //! \param buffer - the data, which must stay valid and unchanged until \a on_complete is called
+    //! \param length - the number of bytes in \a buffer
+    //! \param on_complete - called once the kernel is done with the bytes sent; moved from only if any were sent
+    //! \param flags - further flags for \c send (2)
+    //!
+    //! \return the number of bytes sent, or an error if none were
+    //!
+    //! If only part of \a buffer is sent, \a on_complete covers that part; send the rest later with a completion of
+    //! its own. Since completions are called in order, the last one means the whole buffer is free. \a on_complete
+    //! may be called before send() returns.
+
+    io_result send(void const * buffer, size_t length, completion && on_complete, int flags = 0);
+
+    //! \brief Reads the socket's error queue and calls the completions of the sends the kernel has released.
+    //!
+    //! \return the number of completions called
+
+    size_t reap();
+
+    //! \brief Returns true if the socket accepted \c SO_ZEROCOPY.
+
+    inline bool enabled() const noexcept;
+
+    //! \brief Returns the number of completions not yet called.
+
+    inline size_t pending() const noexcept;
+
+private:
+    //! \brief A buffer's sends, numbered [first, end) in the kernel's sequence.
+    struct record {
+        uint64_t first;
+        uint64_t end;
+        uint64_t outstanding;           //!< sends not yet released by the kernel
+        bool copied;
+        completion on_complete;
+    };
+
+    //! \brief Marks sends [low, high] released; the kernel's 32-bit numbers are extended to 64 bits.
+
+    void release(uint32_t low, uint32_t high, bool copied) noexcept;
+
+    //! \brief Calls the completions at the front which are no longer outstanding.
+
+    size_t deliver();
+
+private:
+    stream_socket & socket_;
+    bool enabled_;
+    uint64_t next_;                     //!< the number the kernel will give the next zero-copy send
+    std::deque<record> records_;
+};
+
+#include "meridian/network/zerocopy_sender.ipp"
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__network__zerocopy_sender__hpp */
@@ -0,0 +1,14 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+bool zerocopy_sender::enabled() const noexcept
+{
+    return enabled_;
+}
+
+
+size_t zerocopy_sender::pending() const noexcept
+{
+    return records_.size();
+}
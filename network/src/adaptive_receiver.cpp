@@ -0,0 +1,72 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/network/adaptive_receiver.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using meridian::network::receive_buffer_pool;
+
+//! \brief The largest buffer a receive_buffer_pool lends, and so the largest read.
+uint32_t const LARGEST = receive_buffer_pool::SMALLEST << (receive_buffer_pool::CLASSES - 1);
+
+} // namespace
+
+namespace meridian {
+namespace network {
+
+adaptive_receiver::adaptive_receiver(size_t initial, size_t minimum, size_t maximum, bool use_available) noexcept
+    : minimum_(std::min(round_up_to_power_of_two(minimum), LARGEST))
+    , maximum_(std::min(std::max(round_up_to_power_of_two(maximum), minimum_), LARGEST))
+    , size_(clamp(initial))
+    , average_(size_)
+    , use_available_(use_available)
+{
+}
+
+
+void adaptive_receiver::record(size_t bytes) noexcept
+{
+    if (bytes >= size_) {
+        size_ = clamp(size_ * size_t(2));
+        average_ = size_;
+        return;
+    }
+
+    average_ = average_ - average_ / 4 + static_cast<uint32_t>(bytes / 4);
+    if (clamp(average_) < size_) {
+        size_ = clamp(size_ / 2);
+    }
+}
+
+
+void adaptive_receiver::hint(size_t bytes) noexcept
+{
+    if (bytes > size_) {
+        size_ = clamp(bytes);
+        average_ = size_;
+    }
+}
+
+
+size_t adaptive_receiver::clamp(size_t size) const noexcept
+{
+    return std::min(std::max(round_up_to_power_of_two(size), minimum_), maximum_);
+}
+
+
+uint32_t adaptive_receiver::round_up_to_power_of_two(size_t size) noexcept
+{
+    uint32_t rounded = 1;
+    while (rounded < size && rounded < (uint32_t(1) << 31)) {
+        rounded *= 2;
+    }
+
+    return rounded;
+}
+
+} // namespace network
+} // namespace meridian
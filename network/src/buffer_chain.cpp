@@ -0,0 +1,365 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/network/buffer_chain.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace meridian {
+namespace network {
+
+size_t const buffer_chain::SEGMENT_SIZE;
+size_t const buffer_chain::MAX_VECTORS;
+size_t const buffer_chain::npos;
+
+
+buffer_chain::segment_pool & buffer_chain::local_pool()
+{
+    static thread_local segment_pool pool;
+    return pool;
+}
+
+
+buffer_chain::buffer_chain(segment_pool & pool)
+    : pool_(&pool)
+    , nodes_()
+    , size_(0)
+{
+}
+
+
+buffer_chain::buffer_chain(buffer_chain && chain)
+    : pool_(chain.pool_)
+    , nodes_(std::move(chain.nodes_))
+    , size_(chain.size_)
+{
+    chain.nodes_.clear();
+    chain.size_ = 0;
+}
+
+
+buffer_chain & buffer_chain::operator=(buffer_chain && chain)
+{
+    if (this != &chain) {
+        pool_ = chain.pool_;
+        nodes_ = std::move(chain.nodes_);
+        size_ = chain.size_;
+        chain.nodes_.clear();
+        chain.size_ = 0;
+    }
+
+    return *this;
+}
+
+
+void buffer_chain::append(void const * data, size_t length)
+{
+    char const * bytes = static_cast<char const *>(data);
+
+    while (length) {
+        if (nodes_.empty() || nodes_.back().writable() == 0) {
+            nodes_.emplace_back(pool_->make());
+        }
+
+        node & back = nodes_.back();
+        size_t const chunk = std::min(length, back.writable());
+        std::memcpy(back.data + back.end, bytes, chunk);
+        back.end += chunk;
+        size_ += chunk;
+        bytes += chunk;
+        length -= chunk;
+    }
+}
+
+
+void buffer_chain::append_reference(void const * data, size_t length, release_callback release)
+{
+    if (length == 0) {
+        if (release) {
+            release();
+        }
+        return;
+    }
+
+    trim_back();
+    nodes_.emplace_back(data, length, std::move(release));
+    size_ += length;
+}
+
+
+void buffer_chain::append(buffer_chain && chain)
+{
+    trim_back();
+    for (node & n : chain.nodes_) {
+        nodes_.push_back(std::move(n));
+    }
+
+    size_ += chain.size_;
+    chain.nodes_.clear();
+    chain.size_ = 0;
+}
+
+
+void buffer_chain::prepend(void const * data, size_t length)
+{
+    char const * bytes = static_cast<char const *>(data) + length;
+
+    while (length) {
+        if (nodes_.empty() || !nodes_.front().storage || nodes_.front().begin == 0) {
+            // Fill a new segment from its end, so the next prepend can use the space before it.
+            nodes_.emplace_front(pool_->make());
+            nodes_.front().begin = nodes_.front().end = SEGMENT_SIZE;
+        }
+
+        node & front = nodes_.front();
+        size_t const chunk = std::min(length, front.begin);
+        front.begin -= chunk;
+        bytes -= chunk;
+        std::memcpy(front.data + front.begin, bytes, chunk);
+        size_ += chunk;
+        length -= chunk;
+    }
+}
+
+
+void buffer_chain::prepend_reference(void const * data, size_t length, release_callback release)
+{
+    if (length == 0) {
+        if (release) {
+            release();
+        }
+        return;
+    }
+
+    nodes_.emplace_front(data, length, std::move(release));
+    size_ += length;
+}
+
+
+void buffer_chain::prepend(buffer_chain && chain)
+{
+    chain.trim_back();
+    for (auto n = chain.nodes_.rbegin(); n != chain.nodes_.rend(); ++n) {
+        nodes_.push_front(std::move(*n));
+    }
+
+    size_ += chain.size_;
+    chain.nodes_.clear();
+    chain.size_ = 0;
+}
+
+
+void buffer_chain::consume(size_t length)
+{
+    length = std::min(length, size_);
+    size_ -= length;
+
+    while (!nodes_.empty()) {
+        node & front = nodes_.front();
+        size_t const chunk = std::min(length, front.readable());
+        front.begin += chunk;
+        length -= chunk;
+
+        if (front.readable()) {
+            break;
+        }
+        nodes_.pop_front();
+    }
+}
+
+
+void buffer_chain::clear()
+{
+    nodes_.clear();
+    size_ = 0;
+}
+
+
+size_t buffer_chain::copy_out(void * buffer, size_t length, size_t offset) const
+{
+    char * out = static_cast<char *>(buffer);
+    size_t copied = 0;
+
+    for (node const & n : nodes_) {
+        if (copied == length) {
+            break;
+        }
+        if (offset >= n.readable()) {
+            offset -= n.readable();
+            continue;
+        }
+
+        size_t const chunk = std::min(length - copied, n.readable() - offset);
+        std::memcpy(out + copied, n.data + n.begin + offset, chunk);
+        copied += chunk;
+        offset = 0;
+    }
+
+    return copied;
+}
+
+
+size_t buffer_chain::find(void const * pattern, size_t length, size_t from) const
+{
+    char const * needle = static_cast<char const *>(pattern);
+    if (length == 0) {
+        return from <= size_ ? from : npos;
+    }
+
+    // Scan for the first byte a segment at a time; compare the rest with a cursor which may cross segments.
+    size_t position = 0;
+    for (size_t index = 0; index < nodes_.size(); ++index) {
+        node const & n = nodes_[index];
+        char const * const start = n.data + n.begin;
+        size_t const readable = n.readable();
+        size_t skip = from > position ? std::min(from - position, readable) : 0;
+
+        while (skip < readable) {
+            char const * hit = static_cast<char const *>(std::memchr(start + skip, needle[0], readable - skip));
+            if (!hit) {
+                break;
+            }
+
+            size_t const offset = hit - start;
+            if (position + offset + length > size_) {
+                return npos;
+            }
+
+            size_t matched = 1;
+            size_t node_index = index;
+            size_t node_offset = offset + 1;
+            while (matched < length) {
+                while (node_offset == nodes_[node_index].readable()) {
+                    ++node_index;
+                    node_offset = 0;
+                }
+                node const & m = nodes_[node_index];
+                if (m.data[m.begin + node_offset] != needle[matched]) {
+                    break;
+                }
+                ++matched;
+                ++node_offset;
+            }
+
+            if (matched == length) {
+                return position + offset;
+            }
+            skip = offset + 1;
+        }
+
+        position += readable;
+    }
+
+    return npos;
+}
+
+
+size_t buffer_chain::peek(iovec * vectors, size_t count) const
+{
+    size_t used = 0;
+
+    for (node const & n : nodes_) {
+        if (used == count) {
+            break;
+        }
+        if (n.readable()) {
+            vectors[used].iov_base = n.data + n.begin;
+            vectors[used].iov_len = n.readable();
+            ++used;
+        }
+    }
+
+    return used;
+}
+
+
+size_t buffer_chain::reserve(size_t length, iovec * vectors, size_t count)
+{
+    size_t available = nodes_.empty() ? 0 : nodes_.back().writable();
+    while (available < length) {
+        nodes_.emplace_back(pool_->make());
+        available += SEGMENT_SIZE;
+    }
+
+    // The space starts in the last segment holding data, or the first empty one after it.
+    size_t index = nodes_.size();
+    while (index > 0 && nodes_[index - 1].readable() == 0 && nodes_[index - 1].writable()) {
+        --index;
+    }
+    if (index > 0 && nodes_[index - 1].writable()) {
+        --index;
+    }
+
+    size_t used = 0;
+    for (; index < nodes_.size() && used < count; ++index) {
+        node & n = nodes_[index];
+        if (n.writable()) {
+            vectors[used].iov_base = n.data + n.end;
+            vectors[used].iov_len = n.writable();
+            ++used;
+        }
+    }
+
+    return used;
+}
+
+
+void buffer_chain::commit(size_t length)
+{
+    size_t index = nodes_.size();
+    while (index > 0 && nodes_[index - 1].readable() == 0 && nodes_[index - 1].writable()) {
+        --index;
+    }
+    if (index > 0 && nodes_[index - 1].writable()) {
+        --index;
+    }
+
+    for (; index < nodes_.size() && length; ++index) {
+        node & n = nodes_[index];
+        size_t const chunk = std::min(length, n.writable());
+        n.end += chunk;
+        size_ += chunk;
+        length -= chunk;
+    }
+
+    trim_back();
+}
+
+
+io_result buffer_chain::write_to(stream_socket & socket, int flags)
+{
+    iovec vectors[MAX_VECTORS];
+    size_t const count = peek(vectors, MAX_VECTORS);
+
+    io_result result = socket.send_vectored(vectors, count, flags, std::nothrow);
+    if (result.ok()) {
+        consume(result.bytes());
+    }
+
+    return result;
+}
+
+
+io_result buffer_chain::read_from(stream_socket & socket, size_t length, int flags)
+{
+    iovec vectors[MAX_VECTORS];
+    size_t const count = reserve(length, vectors, MAX_VECTORS);
+
+    io_result result = socket.receive_vectored(vectors, count, flags, std::nothrow);
+    commit(result.ok() ? result.bytes() : 0);
+
+    return result;
+}
+
+
+void buffer_chain::trim_back() noexcept
+{
+    while (!nodes_.empty() && nodes_.back().storage && nodes_.back().readable() == 0) {
+        nodes_.pop_back();
+    }
+}
+
+} // namespace network
+} // namespace meridian
@@ -0,0 +1,398 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/network/datagram_socket.hpp"
+#include "meridian/network/exception.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/un.h>
+
+namespace {
+
+using namespace meridian::network;
+
+#if defined(__linux__)
+
+typedef mmsghdr message_header;
+
+inline int receive_messages(int fd, message_header * messages, size_t count, int flags)
+{
+    return ::recvmmsg(fd, messages, count, flags | MSG_WAITFORONE, nullptr);
+}
+
+
+inline int send_messages(int fd, message_header * messages, size_t count, int flags)
+{
+    return ::sendmmsg(fd, messages, count, flags);
+}
+
+#else
+
+//! \brief The layout of Linux's \c mmsghdr, for the one-message-per-call fallback.
+struct message_header {
+    msghdr msg_hdr;
+    unsigned msg_len;
+};
+
+inline int receive_messages(int fd, message_header * messages, size_t count, int flags)
+{
+    size_t index = 0;
+    for (; index < count; ++index) {
+        ssize_t result = ::recvmsg(fd, &messages[index].msg_hdr, index ? flags | MSG_DONTWAIT : flags);
+        if (result < 0) {
+            if (index) {
+                break;
+            }
+            return -1;
+        }
+        messages[index].msg_len = result;
+    }
+    return index;
+}
+
+
+inline int send_messages(int fd, message_header * messages, size_t count, int flags)
+{
+    size_t index = 0;
+    for (; index < count; ++index) {
+        ssize_t result = ::sendmsg(fd, &messages[index].msg_hdr, flags);
+        if (result < 0) {
+            if (index) {
+                break;
+            }
+            return -1;
+        }
+        messages[index].msg_len = result;
+    }
+    return index;
+}
+
+#endif
+
+//! \brief Returns the count of a successful \a result, or throws its error as a failure of \a function_name.
+
+inline size_t count_or_throw(io_result result, char const * function_name)
+{
+    if (!result.ok()) {
+        throw exception()
+            << boost::errinfo_errno(result.error())
+            << boost::errinfo_api_function(function_name);
+    }
+
+    return result.bytes();
+}
+
+
+//! \brief Sets \a address from the sender's address written by the kernel, if it's of a kind socket_address holds
+//! (an unbound \c AF_UNIX sender, for one, has no address).
+
+inline void store_address(socket_address & address, sockaddr_storage & addr, socklen_t length)
+{
+    switch (length) {
+        case sizeof(sockaddr_in):
+        case sizeof(sockaddr_in6):
+        case sizeof(sockaddr_un):
+            address = socket_address(reinterpret_cast<sockaddr *>(&addr), length);
+            break;
+
+        default:
+            address = socket_address();
+            break;
+    }
+}
+
+}
+
+namespace meridian {
+namespace network {
+
+size_t const datagram_socket::MAX_BATCH;
+
+
+datagram_socket::datagram_socket(socket_domain domain, int protocol)
+    : socket{ ::socket(socket_domain_to_af(domain), SOCK_DGRAM, protocol) }
+{
+}
+
+
+void datagram_socket::connect(socket_address const & address)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    if (::connect(fd(), address.addr(), address.length()) < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("connect");
+    }
+}
+
+
+size_t datagram_socket::receive_batch(datagram * datagrams, size_t count, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    return count_or_throw(receive_batch(datagrams, count, flags, std::nothrow), "recvmmsg");
+}
+
+
+size_t datagram_socket::send_batch(datagram const * datagrams, size_t count, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    return count_or_throw(send_batch(datagrams, count, flags, std::nothrow), "sendmmsg");
+}
+
+
+io_result datagram_socket::receive_batch(datagram * datagrams, size_t count, int flags, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    size_t received = 0;
+    while (received < count) {
+        size_t const batch = std::min(count - received, MAX_BATCH);
+        message_header messages[MAX_BATCH];
+        iovec vectors[MAX_BATCH];
+        sockaddr_storage addresses[MAX_BATCH];
+
+        for (size_t index = 0; index < batch; ++index) {
+            datagram & d = datagrams[received + index];
+            vectors[index].iov_base = d.buffer;
+            vectors[index].iov_len = d.capacity;
+
+            msghdr & header = messages[index].msg_hdr;
+            header = msghdr();
+            header.msg_name = &addresses[index];
+            header.msg_namelen = sizeof(addresses[index]);
+            header.msg_iov = &vectors[index];
+            header.msg_iovlen = 1;
+            messages[index].msg_len = 0;
+        }
+
+        // Only the first call may wait; later ones take what has already arrived.
+        int result = receive_messages(fd(), messages, batch, received ? flags | MSG_DONTWAIT : flags);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (received) {
+                break;
+            }
+            return io_result::failure(errno);
+        }
+
+        for (int index = 0; index < result; ++index) {
+            datagram & d = datagrams[received + index];
+            msghdr const & header = messages[index].msg_hdr;
+            d.length = messages[index].msg_len;
+            d.truncated = header.msg_flags & MSG_TRUNC;
+            store_address(d.address, addresses[index], header.msg_namelen);
+        }
+
+        received += result;
+        if (static_cast<size_t>(result) < batch) {
+            break;
+        }
+    }
+
+    return io_result::success(received);
+}
+
+
+io_result datagram_socket::send_batch(
+        datagram const * datagrams,
+        size_t count,
+        int flags,
+        std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    size_t sent = 0;
+    while (sent < count) {
+        size_t const batch = std::min(count - sent, MAX_BATCH);
+        message_header messages[MAX_BATCH];
+        iovec vectors[MAX_BATCH];
+
+        for (size_t index = 0; index < batch; ++index) {
+            datagram const & d = datagrams[sent + index];
+            vectors[index].iov_base = d.buffer;
+            vectors[index].iov_len = d.length;
+
+            msghdr & header = messages[index].msg_hdr;
+            header = msghdr();
+            if (d.address.length()) {
+                header.msg_name = const_cast<sockaddr *>(d.address.addr());
+                header.msg_namelen = d.address.length();
+            }
+            header.msg_iov = &vectors[index];
+            header.msg_iovlen = 1;
+            messages[index].msg_len = 0;
+        }
+
+        int result = send_messages(fd(), messages, batch, flags);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (sent) {
+                break;
+            }
+            return io_result::failure(errno);
+        }
+
+        sent += result;
+        if (static_cast<size_t>(result) < batch) {
+            break;
+        }
+    }
+
+    return io_result::success(sent);
+}
+
+void datagram_socket::set_udp_gro(bool flag)
+{
+#if defined(UDP_GRO)
+    int const value = flag ? 1 : 0;
+    set_socket_option(IPPROTO_UDP, UDP_GRO, value);
+#else
+    throw unsupported_operation_exception() << core::exception_message("UDP_GRO is not supported on this system");
+#endif
+}
+
+
+bool datagram_socket::get_udp_gro() const
+{
+#if defined(UDP_GRO)
+    return get_int_socket_option(IPPROTO_UDP, UDP_GRO) != 0;
+#else
+    return false;
+#endif
+}
+
+
+size_t datagram_socket::send_segmented(
+        void const * buffer,
+        size_t length,
+        std::uint16_t segment_size,
+        socket_address const & address,
+        int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    return count_or_throw(send_segmented(buffer, length, segment_size, address, flags, std::nothrow), "sendmsg");
+}
+
+
+size_t datagram_socket::receive_segmented(
+        void * buffer,
+        size_t capacity,
+        socket_address & address,
+        size_t & segment_size,
+        int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    return count_or_throw(receive_segmented(buffer, capacity, address, segment_size, flags, std::nothrow), "recvmsg");
+}
+
+
+io_result datagram_socket::send_segmented(
+        void const * buffer,
+        size_t length,
+        std::uint16_t segment_size,
+        socket_address const & address,
+        int flags,
+        std::nothrow_t const &) noexcept
+{
+#if defined(UDP_SEGMENT)
+    iovec vector = { const_cast<void *>(buffer), length };
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(std::uint16_t))];
+    } control;
+    std::memset(&control, 0, sizeof(control));
+
+    msghdr message = msghdr();
+    if (address.length()) {
+        message.msg_name = const_cast<sockaddr *>(address.addr());
+        message.msg_namelen = address.length();
+    }
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    cmsghdr * header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = IPPROTO_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(segment_size));
+    std::memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+
+    return send_message(message, flags, std::nothrow);
+#else
+    return io_result::failure(ENOPROTOOPT);
+#endif
+}
+
+
+io_result datagram_socket::receive_segmented(
+        void * buffer,
+        size_t capacity,
+        socket_address & address,
+        size_t & segment_size,
+        int flags,
+        std::nothrow_t const &) noexcept
+{
+    iovec vector = { buffer, capacity };
+    sockaddr_storage addr;
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    msghdr message = msghdr();
+    message.msg_name = &addr;
+    message.msg_namelen = sizeof(addr);
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    io_result result = receive_message(message, flags, std::nothrow);
+    if (!result.ok()) {
+        return result;
+    }
+
+    segment_size = result.bytes();
+#if defined(UDP_GRO)
+    for (cmsghdr * header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == IPPROTO_UDP && header->cmsg_type == UDP_GRO) {
+            int size;
+            std::memcpy(&size, CMSG_DATA(header), sizeof(size));
+            segment_size = size;
+        }
+    }
+#endif
+
+    store_address(address, addr, message.msg_namelen);
+    return result;
+}
+
+} // namespace network
+} // namespace meridian
@@ -0,0 +1,186 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/network/file_transfer.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+using meridian::network::io_result;
+
+//! \brief Returns what a send() which has already sent \a sent bytes reports for \a result: the progress, if any.
+
+inline io_result progress_or(size_t sent, io_result result)
+{
+    return sent ? io_result::success(sent) : result;
+}
+
+}
+
+namespace meridian {
+namespace network {
+
+splice_pipe_cache::splice_pipe_cache(size_t capacity)
+    : capacity_(capacity)
+    , pipes_()
+{
+    pipes_.reserve(capacity);
+}
+
+
+splice_pipe_cache::~splice_pipe_cache()
+{
+    for (splice_pipe const & pipe : pipes_) {
+        ::close(pipe.read_fd);
+        ::close(pipe.write_fd);
+    }
+}
+
+
+int splice_pipe_cache::acquire(splice_pipe & pipe) noexcept
+{
+    if (!pipes_.empty()) {
+        pipe = pipes_.back();
+        pipes_.pop_back();
+        return 0;
+    }
+
+    int fds[2];
+    if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+        return errno;
+    }
+
+    pipe.read_fd = fds[0];
+    pipe.write_fd = fds[1];
+    return 0;
+}
+
+
+void splice_pipe_cache::release(splice_pipe const & pipe, bool empty) noexcept
+{
+    if (empty && pipes_.size() < capacity_) {
+        pipes_.push_back(pipe);
+        return;
+    }
+
+    ::close(pipe.read_fd);
+    ::close(pipe.write_fd);
+}
+
+
+file_transfer::file_transfer(int file_fd, off_t offset, size_t length, method how) noexcept
+    : file_fd_(file_fd)
+    , offset_(offset)
+    , unread_(length)
+    , buffered_(0)
+    , method_(how)
+    , pipes_(nullptr)
+    , pipe_()
+{
+}
+
+
+file_transfer::~file_transfer()
+{
+    release_pipe();
+}
+
+
+io_result file_transfer::send(stream_socket & socket, splice_pipe_cache & pipes) noexcept
+{
+    size_t sent = 0;
+
+    if (method_ == method::sendfile) {
+        while (unread_) {
+            io_result result = socket.send_file(file_fd_, offset_, unread_, std::nothrow);
+            if (!result.ok()) {
+                if (result.error() != EINVAL && result.error() != ENOSYS) {
+                    return progress_or(sent, result);
+                }
+
+                // sendfile doesn't support this file; nothing was sent by this attempt, so splice instead.
+                method_ = method::splice;
+                break;
+            }
+
+            if (result.bytes() == 0) {
+                return progress_or(sent, io_result::failure(ENODATA));
+            }
+
+            unread_ -= result.bytes();
+            sent += result.bytes();
+        }
+
+        if (method_ == method::sendfile) {
+            return io_result::success(sent);
+        }
+    }
+
+    return splice_to(socket, pipes, sent);
+}
+
+
+io_result file_transfer::splice_to(stream_socket & socket, splice_pipe_cache & pipes, size_t sent) noexcept
+{
+    if (!pipes_ && remaining()) {
+        int error = pipes.acquire(pipe_);
+        if (error) {
+            return progress_or(sent, io_result::failure(error));
+        }
+        pipes_ = &pipes;
+    }
+
+    while (remaining()) {
+        if (buffered_ == 0) {
+            ssize_t result = ::splice(file_fd_, &offset_, pipe_.write_fd, nullptr, unread_,
+                                      SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return progress_or(sent, io_result::failure(errno));
+            }
+            if (result == 0) {
+                return progress_or(sent, io_result::failure(ENODATA));
+            }
+
+            unread_ -= result;
+            buffered_ = result;
+        }
+
+        ssize_t result = ::splice(pipe_.read_fd, nullptr, socket.fd(), nullptr, buffered_,
+                                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK | (unread_ ? SPLICE_F_MORE : 0));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return progress_or(sent, io_result::failure(errno));
+        }
+
+        buffered_ -= result;
+        sent += result;
+    }
+
+    release_pipe();
+    return io_result::success(sent);
+}
+
+
+void file_transfer::release_pipe() noexcept
+{
+    if (pipes_) {
+        pipes_->release(pipe_, buffered_ == 0);
+        pipes_ = nullptr;
+    }
+}
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
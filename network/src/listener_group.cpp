@@ -0,0 +1,105 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/network/listener_group.hpp"
+#include "meridian/network/exception.hpp"
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+namespace meridian {
+namespace network {
+
+listener_group::listener_group(socket_address const & address, size_t size, int backlog)
+    : listeners_()
+{
+    assert(size > 0);
+
+    try {
+        for (size_t index = 0; index < size; ++index) {
+            listeners_.emplace_back(new stream_socket(address.domain()));
+            stream_socket & listener = *listeners_.back();
+
+            listener.set_reuse_address(true);
+            listener.set_reuse_port(true);
+            listener.set_non_blocking(true);
+
+            // If the kernel is to choose the port, it does so once, for the first listener; the rest join that port.
+            // Listeners join the kernel's group in the order they start listening, which is the order of their
+            // indexes.
+
+            if (index == 0) {
+                listener.bind(address);
+            }
+            else {
+                listener.bind(listeners_.front()->address());
+            }
+
+            listener.listen(backlog);
+        }
+    }
+    catch (...) {
+        for (std::unique_ptr<stream_socket> & listener : listeners_) {
+            listener->close_noexcept();
+        }
+        throw;
+    }
+}
+
+
+listener_group::~listener_group()
+{
+    for (std::unique_ptr<stream_socket> & listener : listeners_) {
+        listener->close_noexcept();
+    }
+}
+
+
+socket_address listener_group::address() const
+{
+    return listeners_.front()->address();
+}
+
+
+void listener_group::steer_by_incoming_cpu(std::vector<int> const & cpus)
+{
+    assert(cpus.size() == listeners_.size());
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    // The program returns the index of the listener to use:
+    //
+    //     A = the current CPU
+    //     for each listener i: if A == cpus[i], return i
+    //     return A % size()
+    //
+    // The kernel falls back to hashing if the index is out of range, which the modulus prevents.
+
+    std::vector<sock_filter> program;
+    program.push_back(sock_filter BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+
+    for (size_t index = 0; index < cpus.size(); ++index) {
+        program.push_back(sock_filter BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(cpus[index]), 0, 1));
+        program.push_back(sock_filter BPF_STMT(BPF_RET | BPF_K, static_cast<uint32_t>(index)));
+    }
+
+    program.push_back(sock_filter BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(cpus.size())));
+    program.push_back(sock_filter BPF_STMT(BPF_RET | BPF_A, 0));
+
+    if (program.size() > BPF_MAXINSNS) {
+        throw unsupported_operation_exception() << core::exception_message("too many listeners to steer by CPU");
+    }
+
+    sock_fprog const filter = { static_cast<unsigned short>(program.size()), program.data() };
+
+    // The program belongs to the kernel's group as a whole, so attaching it through any one listener is enough.
+    listeners_.front()->set_raw_socket_option(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &filter, sizeof(filter));
+#else
+    throw unsupported_operation_exception()
+        << core::exception_message("steering connections by CPU is not supported on this system");
+#endif
+}
+
+} // namespace network
+} // namespace meridian
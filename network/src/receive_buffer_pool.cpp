@@ -0,0 +1,91 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/network/receive_buffer_pool.hpp"
+
+#include <cassert>
+
+namespace meridian {
+namespace network {
+
+unsigned const receive_buffer_pool::CLASSES;
+size_t const receive_buffer_pool::SMALLEST;
+
+
+receive_buffer_pool::receive_buffer_pool(size_t max_idle)
+    : max_idle_(max_idle)
+    , idle_()
+    , outstanding_(0)
+{
+    // Reserved up front so that release() never allocates.
+    for (std::vector<char *> & idle : idle_) {
+        idle.reserve(max_idle);
+    }
+}
+
+
+receive_buffer_pool::~receive_buffer_pool()
+{
+    assert(outstanding_ == 0);
+
+    for (std::vector<char *> & idle : idle_) {
+        for (char * data : idle) {
+            delete[] data;
+        }
+    }
+}
+
+
+receive_buffer_pool & receive_buffer_pool::local()
+{
+    static thread_local receive_buffer_pool pool;
+    return pool;
+}
+
+
+receive_buffer_pool::buffer receive_buffer_pool::acquire(size_t size)
+{
+    unsigned const size_class = receive_buffer_pool::size_class(size);
+    std::vector<char *> & idle = idle_[size_class];
+
+    char * data;
+    if (!idle.empty()) {
+        data = idle.back();
+        idle.pop_back();
+    }
+    else {
+        data = new char[class_size(size_class)];
+    }
+
+    ++outstanding_;
+    return buffer(this, data, size_class);
+}
+
+
+size_t receive_buffer_pool::idle() const noexcept
+{
+    size_t total = 0;
+    for (std::vector<char *> const & idle : idle_) {
+        total += idle.size();
+    }
+
+    return total;
+}
+
+
+void receive_buffer_pool::release(char * data, unsigned size_class) noexcept
+{
+    --outstanding_;
+
+    std::vector<char *> & idle = idle_[size_class];
+    if (idle.size() < max_idle_) {
+        idle.push_back(data);
+    }
+    else {
+        delete[] data;
+    }
+}
+
+} // namespace network
+} // namespace meridian
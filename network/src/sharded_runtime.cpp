@@ -0,0 +1,419 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/core/dense_event_source_registry.hpp"
+#include "meridian/network/sharded_runtime.hpp"
+#include "meridian/network/exception.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <set>
+#include <unistd.h>
+
+namespace {
+
+using meridian::network::sharded_runtime;
+
+//! \brief The shard running on this thread, if any.
+thread_local sharded_runtime::shard * current_shard = nullptr;
+
+//! \brief Maximum number of connections one shard accepts per readiness notification.
+size_t const ACCEPT_BUDGET = 64;
+
+//! \brief How long a shard stops accepting after accepting fails.
+std::chrono::milliseconds const ACCEPT_BACKOFF(100);
+
+
+//! \brief Returns the CPUs the process may run on.
+
+std::vector<int> allowed_cpus()
+{
+    std::vector<int> cpus;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+
+    if (cpus.empty()) {
+        cpus.push_back(0);
+    }
+
+    return cpus;
+}
+
+
+//! \brief Pins the calling thread to \a cpu, returning 0 or an \c errno value.
+
+int pin_to_cpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+}
+
+}
+
+namespace meridian {
+namespace network {
+
+//! \brief Holds the shards' threads until every one has pinned itself, and reports the first failure to start().
+
+class sharded_runtime::startup_barrier {
+public:
+    explicit startup_barrier(size_t threads)
+        : mutex_()
+        , changed_()
+        , waiting_(threads)
+        , error_(0)
+        , cancelled_(false)
+    {
+    }
+
+    //! \brief Called by each thread with the result of pinning it; returns true if the thread should run its shard.
+
+    bool arrive(int error)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (error && !error_) {
+            error_ = error;
+        }
+
+        --waiting_;
+        changed_.notify_all();
+        changed_.wait(lock, [this] { return !waiting_ || cancelled_; });
+
+        return !error_ && !cancelled_;
+    }
+
+    //! \brief Waits for every thread to arrive, and returns the first error, or 0.
+
+    int wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return !waiting_; });
+
+        return error_;
+    }
+
+    //! \brief Releases the threads which have started, without running their shards, when not all could be started.
+
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        changed_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    size_t waiting_;
+    int error_;
+    bool cancelled_;
+};
+
+
+//! \brief A task submitted through the target's post() because its channel was full.
+//!
+//! Anything already on the channel was submitted earlier, so it's run first.
+
+class sharded_runtime::overflow_task {
+public:
+    overflow_task(sharded_runtime & runtime, size_t from, size_t to, task function)
+        : runtime_(runtime)
+        , from_(from)
+        , to_(to)
+        , function_(std::move(function))
+    {
+    }
+
+    void operator()() const {
+        runtime_.drain(from_, to_);
+        function_();
+        runtime_.channel_between(from_, to_).overflowed.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    sharded_runtime & runtime_;
+    size_t from_;
+    size_t to_;
+    task function_;
+};
+
+
+sharded_runtime::shard::shard(sharded_runtime & runtime, size_t index, int cpu)
+    : runtime_(runtime)
+    , index_(index)
+    , cpu_(cpu)
+    , wakeup_()
+    , notified_(false)
+    , sockets_()
+    , reactor_(std::unique_ptr<core::abstract_event_source_registry>(new core::dense_event_source_registry))
+{
+}
+
+
+sharded_runtime::channel::channel(size_t capacity)
+    : tasks(capacity)
+    , overflowed(0)
+{
+}
+
+
+sharded_runtime::sharded_runtime(size_t shards, size_t channel_capacity)
+    : shards_()
+    , channels_()
+    , listeners_()
+    , on_connection_()
+    , threads_()
+    , stopping_(false)
+{
+    std::vector<int> const cpus = allowed_cpus();
+    if (!shards) {
+        shards = cpus.size();
+    }
+
+    for (size_t index = 0; index < shards; ++index) {
+        shards_.emplace_back(new shard(*this, index, cpus[index % cpus.size()]));
+    }
+
+    for (size_t index = 0; index < shards * shards; ++index) {
+        channels_.emplace_back(new channel(channel_capacity));
+    }
+}
+
+
+sharded_runtime::~sharded_runtime()
+{
+    stop();
+    join();
+}
+
+
+sharded_runtime::shard * sharded_runtime::current()
+{
+    return current_shard && &current_shard->runtime_ == this ? current_shard : nullptr;
+}
+
+
+void sharded_runtime::listen(socket_address const & address, int backlog, connection_handler handler)
+{
+    assert(threads_.empty());
+
+    std::unique_ptr<listener_group> listeners(new listener_group(address, shards_.size(), backlog));
+
+    std::vector<int> cpus;
+    for (std::unique_ptr<shard> & each : shards_) {
+        cpus.push_back(each->cpu_);
+    }
+
+    if (std::set<int>(cpus.begin(), cpus.end()).size() == cpus.size()) {
+        listeners->steer_by_incoming_cpu(cpus);
+    }
+
+    listeners_ = std::move(listeners);
+    on_connection_ = std::move(handler);
+}
+
+
+socket_address sharded_runtime::listen_address() const
+{
+    assert(listeners_);
+    return listeners_->address();
+}
+
+
+void sharded_runtime::start(shard_function init)
+{
+    assert(threads_.empty());
+
+    // Every thread shares the one init function; it's only destroyed once they've all finished. Each thread pins
+    // itself before it touches its shard, so that all of the shard's work and memory is on its CPU from the start, and
+    // none runs until all have pinned themselves, so that if one can't, none has to be torn down mid-flight.
+
+    std::shared_ptr<shard_function> shared_init = std::make_shared<shard_function>(std::move(init));
+    std::shared_ptr<startup_barrier> startup = std::make_shared<startup_barrier>(shards_.size());
+
+    try {
+        for (std::unique_ptr<shard> & each : shards_) {
+            shard & self = *each;
+            threads_.emplace_back([this, &self, shared_init, startup] {
+                if (startup->arrive(pin_to_cpu(self.cpu_))) {
+                    run(self, *shared_init);
+                }
+            });
+        }
+    }
+    catch (...) {
+        startup->cancel();
+        join();
+        throw;
+    }
+
+    int const error = startup->wait();
+    if (error) {
+        join();
+
+        throw exception()
+            << boost::errinfo_errno(error)
+            << boost::errinfo_api_function("pthread_setaffinity_np");
+    }
+}
+
+
+void sharded_runtime::submit_to(size_t target, task function)
+{
+    assert(target < shards_.size());
+
+    shard & to = *shards_[target];
+    shard * from = current();
+
+    if (!from) {
+        to.reactor_.post(std::move(function));
+        return;
+    }
+
+    channel & between = channel_between(from->index_, target);
+
+    if (between.overflowed.load(std::memory_order_acquire) == 0 && between.tasks.try_push(std::move(function))) {
+        if (!to.notified_.exchange(true, std::memory_order_acq_rel)) {
+            to.wakeup_.notify();
+        }
+        return;
+    }
+
+    between.overflowed.fetch_add(1, std::memory_order_relaxed);
+    to.reactor_.post(overflow_task(*this, from->index_, target, std::move(function)));
+}
+
+
+void sharded_runtime::stop()
+{
+    stopping_.store(true, std::memory_order_release);
+
+    for (std::unique_ptr<shard> & each : shards_) {
+        each->reactor_.post([] { });
+    }
+}
+
+
+void sharded_runtime::join()
+{
+    assert(!current());
+
+    for (std::thread & thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    threads_.clear();
+}
+
+
+void sharded_runtime::run(shard & self, shard_function const & init)
+{
+    current_shard = &self;
+
+    reactor_type::scoped_registration<reactor::event_type::read> wakeup_registration(
+            self.reactor_, self.wakeup_, [this, &self] { on_wakeup(self); });
+
+    if (self.listener()) {
+        self.reactor_.register_read_callback(*self.listener(), [this, &self] { accept_connections(self); });
+    }
+
+    if (init) {
+        init(self);
+    }
+
+    while (!stopping_.load(std::memory_order_acquire)) {
+        self.reactor_.wait_for_events();
+    }
+
+    // The listener's callback is missing if the shard stopped while accepting was paused.
+    if (self.listener() && self.listener()->has_read_callback()) {
+        self.reactor_.remove_read_callback(*self.listener());
+    }
+
+    current_shard = nullptr;
+}
+
+
+void sharded_runtime::accept_connections(shard & self)
+{
+    stream_socket & listener = *self.listener();
+
+    drain_result const result = listener.accept_batch(
+            ACCEPT_BUDGET,
+            [this, &self](int fd, sockaddr const * address, socklen_t length) {
+                stream_socket::pool::handle client;
+                try {
+                    client = self.sockets_.make(fd);
+                }
+                catch (std::bad_alloc const &) {
+                    ::close(fd);
+                    return;
+                }
+
+                on_connection_(self, std::move(client), socket_address(const_cast<sockaddr *>(address), length));
+            });
+
+    if (result.status != drain_status::failed) {
+        return;
+    }
+
+    // Typically the process is out of file descriptors (EMFILE, ENFILE) or buffers (ENOBUFS, ENOMEM). The pending
+    // connections stay queued, so the listener stays readable; rather than fail again on every pass, the shard stops
+    // accepting for a while, during which connections it's serving may close and free what's needed.
+
+    self.reactor_.remove_read_callback(listener);
+    self.reactor_.schedule_after(ACCEPT_BACKOFF, [this, &self] {
+        self.reactor_.register_read_callback(*self.listener(), [this, &self] { accept_connections(self); });
+    });
+}
+
+
+void sharded_runtime::on_wakeup(shard & self)
+{
+    // The flag is cleared before the channels are drained: a task pushed after this point notifies again, and one
+    // pushed before it is visible to the drain below.
+
+    self.wakeup_.consume();
+    self.notified_.exchange(false, std::memory_order_acq_rel);
+
+    for (size_t from = 0; from < shards_.size(); ++from) {
+        drain(from, self.index_);
+    }
+}
+
+
+void sharded_runtime::drain(size_t from, size_t to)
+{
+    reactor::spsc_channel<task> & tasks = channel_between(from, to).tasks;
+
+    task next;
+    while (tasks.try_pop(next)) {
+        next();
+        next = nullptr;
+    }
+}
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
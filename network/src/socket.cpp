@@ -6,6 +6,10 @@
 #include "meridian/network/socket.hpp"
 #include "meridian/network/exception.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 
@@ -34,6 +38,32 @@ inline socket_address get_address_impl(
     return socket_address(reinterpret_cast<sockaddr *>(&addr), addr_length);
 }
 
+
+//! \brief Returns the byte count of a successful \a result, or throws its error as a failure of \a function_name.
+
+inline ssize_t bytes_or_throw(io_result result, char const * function_name)
+{
+    if (!result.ok()) {
+        throw exception()
+            << boost::errinfo_errno(result.error())
+            << boost::errinfo_api_function(function_name);
+    }
+
+    return result.bytes();
+}
+
+
+//! \brief Returns a message header describing \a count segments at \a vectors, capped at \c IOV_MAX.
+
+inline msghdr vectored_message(iovec const * vectors, size_t count)
+{
+    msghdr message = msghdr();
+    message.msg_iov = const_cast<iovec *>(vectors);
+    message.msg_iovlen = std::min<size_t>(count, IOV_MAX);
+
+    return message;
+}
+
 }
 
 namespace meridian {
@@ -41,7 +71,7 @@ namespace network {
 
 void socket::close()
 {
-    if (::close(fd_) != 0) {
+    if (::close(fd()) != 0) {
         throw exception() << boost::errinfo_errno(errno) << boost::errinfo_api_function("close");
     }
 }
@@ -49,7 +79,7 @@ void socket::close()
 
 void socket::close_noexcept() noexcept
 {
-    ::close(fd_);
+    ::close(fd());
 }
 
 
@@ -146,11 +176,11 @@ socket::time_duration socket::get_time_duration_socket_option(int level, int opt
 
 void socket::set_raw_socket_option(int level, int option, void const * value, size_t length)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    if (::setsockopt(fd_, level, option, value, length) < 0) {
+    if (::setsockopt(fd(), level, option, value, length) < 0) {
         throw exception() << boost::errinfo_errno(errno) << boost::errinfo_api_function("setsockopt");
     }
 }
@@ -158,11 +188,11 @@ void socket::set_raw_socket_option(int level, int option, void const * value, si
 
 void socket::get_raw_socket_option(int level, int option, void * value, socklen_t & length) const
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    if (::getsockopt(fd_, level, option, value, &length) < 0) {
+    if (::getsockopt(fd(), level, option, value, &length) < 0) {
         throw exception() << boost::errinfo_errno(errno) << boost::errinfo_api_function("getsockopt");
     }
 }
@@ -170,13 +200,13 @@ void socket::get_raw_socket_option(int level, int option, void * value, socklen_
 
 socket_address socket::address() const
 {
-    return get_address_impl(fd_, "getsockname", ::getsockname);
+    return get_address_impl(fd(), "getsockname", ::getsockname);
 }
 
 
 socket_address socket::peer_address() const
 {
-    return get_address_impl(fd_, "getpeername", ::getpeername);
+    return get_address_impl(fd(), "getpeername", ::getpeername);
 }
 
 
@@ -222,24 +252,104 @@ void socket::set_reuse_address(bool flag)
     set_socket_option(SOL_SOCKET, SO_REUSEADDR, value);
 }
 
+
+bool socket::get_reuse_address() const
+{
+    return get_int_socket_option(SOL_SOCKET, SO_REUSEADDR) != 0;
+}
+
+
+void socket::set_reuse_port(bool flag)
+{
+#if defined(SO_REUSEPORT)
+    int const value = flag ? 1 : 0;
+    set_socket_option(SOL_SOCKET, SO_REUSEPORT, value);
+#else
+    throw unsupported_operation_exception() << core::exception_message("SO_REUSEPORT is not supported on this system");
+#endif
+}
+
+
+bool socket::get_reuse_port() const
+{
+#if defined(SO_REUSEPORT)
+    return get_int_socket_option(SOL_SOCKET, SO_REUSEPORT) != 0;
+#else
+    return false;
+#endif
+}
+
+
+int socket::get_incoming_cpu() const
+{
+#if defined(SO_INCOMING_CPU)
+    return get_int_socket_option(SOL_SOCKET, SO_INCOMING_CPU);
+#else
+    throw unsupported_operation_exception()
+        << core::exception_message("SO_INCOMING_CPU is not supported on this system");
+#endif
+}
+
+
+void socket::set_non_blocking(bool flag)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    int flags = ::fcntl(fd(), F_GETFL);
+    if (flags < 0 || ::fcntl(fd(), F_SETFL, flag ? flags | O_NONBLOCK : flags & ~O_NONBLOCK) < 0) {
+        throw exception() << boost::errinfo_errno(errno) << boost::errinfo_api_function("fcntl");
+    }
+}
+
+
+bool socket::get_non_blocking() const
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    int flags = ::fcntl(fd(), F_GETFL);
+    if (flags < 0) {
+        throw exception() << boost::errinfo_errno(errno) << boost::errinfo_api_function("fcntl");
+    }
+
+    return flags & O_NONBLOCK;
+}
+
+
 int socket::available()
 {
-    return core::ioctl<int>(fd_, FIONREAD);
+    return core::ioctl<int>(fd(), FIONREAD);
+}
+
+
+io_result socket::available(std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    int bytes = 0;
+    if (::ioctl(fd(), FIONREAD, &bytes) < 0) {
+        return io_result::failure(errno);
+    }
+
+    return io_result::success(bytes);
 }
 
 
 socket::socket()
     : core::event_source(INVALID_SOCKET_FD)
-    , fd_(INVALID_SOCKET_FD)
 {
 }
 
 
 socket::socket(int fd)
     : core::event_source(fd)
-    , fd_(fd)
 {
-    if (fd_ < 0) {
+    if (fd < 0) {
         throw exception() << core::exception_message("invalid fd");
     }
 }
@@ -247,14 +357,17 @@ socket::socket(int fd)
 
 void socket::init(socket_domain domain, int type, int proto)
 {
-    assert(fd_ == INVALID_SOCKET_FD);
+    assert(fd() == INVALID_SOCKET_FD);
 
-    if ((fd_ = ::socket(socket_domain_to_af(domain), type, proto)) < 0) {
+    int fd = ::socket(socket_domain_to_af(domain), type, proto);
+    if (fd < 0) {
         throw exception()
             << boost::errinfo_errno(errno)
-            << boost::errinfo_api_function("recv");
+            << boost::errinfo_api_function("socket");
     }
 
+    reset_fd(fd);
+
 #if defined(__MACH__) && defined(__APPLE__) || defined(__FreeBSD__)
     set_socket_option(SOL_SOCKET, SO_NOSIGPIPE, 1);
 #endif
@@ -263,88 +376,268 @@ void socket::init(socket_domain domain, int type, int proto)
 
 ssize_t socket::receive(void * buffer, size_t length, int flags)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    ssize_t result = ::recv(fd_, buffer, length, flags);
-    if (result < 0) {
-        throw exception()
-            << boost::errinfo_errno(errno)
-            << boost::errinfo_api_function("recv");
+    return bytes_or_throw(receive(buffer, length, flags, std::nothrow), "recv");
+}
+
+
+ssize_t socket::send(void const * buffer, size_t length, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
     }
-    else {
-        return result;
+
+    return bytes_or_throw(send(buffer, length, flags, std::nothrow), "send");
+}
+
+
+ssize_t socket::receive_from(void * buffer, size_t length, int flags, socket_address & address)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
     }
+
+    return bytes_or_throw(receive_from(buffer, length, flags, address, std::nothrow), "recvfrom");
 }
 
 
-ssize_t socket::send(void const * buffer, size_t length, int flags)
+ssize_t socket::send_to(void const * buffer, size_t length, int flags, socket_address const & address)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    ssize_t result = ::send(fd_, buffer, length, flags);
-    if (result < 0) {
-        throw exception()
-            << boost::errinfo_errno(errno)
-            << boost::errinfo_api_function("send");
+    return bytes_or_throw(send_to(buffer, length, flags, address, std::nothrow), "sendto");
+}
+
+
+io_result socket::receive(void * buffer, size_t length, int flags, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
     }
-    else {
-        return result;
+
+    for (;;) {
+        ssize_t result = ::recv(fd(), buffer, length, flags);
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
     }
 }
 
 
-ssize_t socket::receive_from(void * buffer, size_t length, int flags, socket_address & address)
+io_result socket::send(void const * buffer, size_t length, int flags, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        ssize_t result = ::send(fd(), buffer, length, flags);
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
+    }
+}
+
+
+io_result socket::receive_from(
+        void * buffer,
+        size_t length,
+        int flags,
+        socket_address & address,
+        std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        sockaddr_storage addr;
+        socklen_t addr_length = sizeof(addr);
+
+        ssize_t result = ::recvfrom(fd(), buffer, length, flags, reinterpret_cast<sockaddr *>(&addr), &addr_length);
+        if (result >= 0) {
+            address = socket_address(reinterpret_cast<sockaddr *>(&addr), addr_length);
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
+    }
+}
+
+
+io_result socket::send_to(
+        void const * buffer,
+        size_t length,
+        int flags,
+        socket_address const & address,
+        std::nothrow_t const &) noexcept
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        ssize_t result = ::sendto(fd(), buffer, length, flags, address.addr(), address.length());
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
+    }
+}
+
+
+ssize_t socket::receive_vectored(iovec const * vectors, size_t count, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    sockaddr_storage addr;
-    socklen_t addr_length = sizeof(addr);
+    return bytes_or_throw(receive_vectored(vectors, count, flags, std::nothrow), "recvmsg");
+}
 
-    ssize_t result = ::recvfrom(fd_, buffer, length, flags, reinterpret_cast<sockaddr *>(&addr), &addr_length);
-    if (result < 0) {
-        throw exception()
-            << boost::errinfo_errno(errno)
-            << boost::errinfo_api_function("send");
+
+ssize_t socket::send_vectored(iovec const * vectors, size_t count, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
     }
-    else {
-        address = socket_address(reinterpret_cast<sockaddr *>(&addr), addr_length);
 
-        return result;
+    return bytes_or_throw(send_vectored(vectors, count, flags, std::nothrow), "sendmsg");
+}
+
+
+ssize_t socket::send_vectored(iovec_cursor & cursor, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
     }
+
+    return bytes_or_throw(send_vectored(cursor, flags, std::nothrow), "sendmsg");
 }
 
 
-ssize_t socket::send_to(void const * buffer, size_t length, int flags, socket_address const & address)
+ssize_t socket::receive_vectored(iovec_cursor & cursor, int flags)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    ssize_t result = ::sendto(fd_, buffer, length, flags, address.addr(), address.length());
-    if (result < 0) {
-        throw exception()
-            << boost::errinfo_errno(errno)
-            << boost::errinfo_api_function("send");
+    return bytes_or_throw(receive_vectored(cursor, flags, std::nothrow), "recvmsg");
+}
+
+
+ssize_t socket::receive_message(msghdr & message, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
     }
-    else {
-        return result;
+
+    return bytes_or_throw(receive_message(message, flags, std::nothrow), "recvmsg");
+}
+
+
+ssize_t socket::send_message(msghdr const & message, int flags)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    return bytes_or_throw(send_message(message, flags, std::nothrow), "sendmsg");
+}
+
+
+io_result socket::receive_vectored(iovec const * vectors, size_t count, int flags, std::nothrow_t const &) noexcept
+{
+    msghdr message = vectored_message(vectors, count);
+    return receive_message(message, flags, std::nothrow);
+}
+
+
+io_result socket::send_vectored(iovec const * vectors, size_t count, int flags, std::nothrow_t const &) noexcept
+{
+    return send_message(vectored_message(vectors, count), flags, std::nothrow);
+}
+
+
+io_result socket::send_vectored(iovec_cursor & cursor, int flags, std::nothrow_t const &) noexcept
+{
+    io_result result = send_vectored(cursor.data(), cursor.count(), flags, std::nothrow);
+    if (result.ok()) {
+        cursor.advance(result.bytes());
+    }
+
+    return result;
+}
+
+
+io_result socket::receive_vectored(iovec_cursor & cursor, int flags, std::nothrow_t const &) noexcept
+{
+    io_result result = receive_vectored(cursor.data(), cursor.count(), flags, std::nothrow);
+    if (result.ok()) {
+        cursor.advance(result.bytes());
+    }
+
+    return result;
+}
+
+
+io_result socket::receive_message(msghdr & message, int flags, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        ssize_t result = ::recvmsg(fd(), &message, flags);
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
+    }
+}
+
+
+io_result socket::send_message(msghdr const & message, int flags, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        ssize_t result = ::sendmsg(fd(), &message, flags);
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
     }
 }
 
 
 void socket::bind(socket_address const & address)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    if (::bind(fd_, address.addr(), address.length()) < 0) {
+    if (::bind(fd(), address.addr(), address.length()) < 0) {
         throw exception()
             << boost::errinfo_errno(errno)
             << boost::errinfo_api_function("bind");
@@ -354,11 +647,11 @@ void socket::bind(socket_address const & address)
 
 void socket::listen(int backlog)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    if (::listen(fd_, backlog) < 0) {
+    if (::listen(fd(), backlog) < 0) {
         throw exception()
             << boost::errinfo_errno(errno)
             << boost::errinfo_api_function("listen");
@@ -386,11 +679,11 @@ void socket::shutdown()
 
 void socket::shutdown(int how)
 {
-    if (fd_ == INVALID_SOCKET_FD) {
+    if (fd() == INVALID_SOCKET_FD) {
         throw invalid_socket_exception();
     }
 
-    if (::shutdown(fd_, how) < 0) {
+    if (::shutdown(fd(), how) < 0) {
         throw exception()
             << boost::errinfo_errno(errno)
             << boost::errinfo_api_function("shutdown");
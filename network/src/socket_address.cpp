@@ -41,7 +41,7 @@ socket_address::socket_address(sockaddr * address, socklen_t length)
 
 
 socket_address::socket_address(socket_address const & address)
-    : addr_{ }
+    : addr_(address.addr_)
     , length_{ address.length_ }
 {
 }
@@ -5,6 +5,125 @@
 #include "meridian/network/stream_socket.hpp"
 #include "meridian/network/exception.hpp"
 
+#if defined(__linux__)
+
+#include <new>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace meridian;
+using meridian::network::stream_socket;
+
+//! \brief A receive or send into a caller-supplied buffer.
+
+class transfer_operation : public reactor::io_uring_operation {
+public:
+    explicit transfer_operation(stream_socket::completion_handler handler)
+        : handler_(std::move(handler))
+    {
+    }
+
+    void complete(io_uring_cqe const & cqe) override {
+        std::unique_ptr<transfer_operation> self(this);
+
+        if (cqe.res < 0) {
+            handler_(-cqe.res, 0);
+        }
+        else {
+            handler_(0, cqe.res);
+        }
+    }
+
+private:
+    stream_socket::completion_handler handler_;
+};
+
+
+//! \brief A receive into a buffer selected from a provided-buffer group.
+
+class provided_receive_operation : public reactor::io_uring_operation {
+public:
+    provided_receive_operation(reactor::io_uring_buffer_group & buffers, stream_socket::provided_buffer_handler handler)
+        : buffers_(buffers)
+        , handler_(std::move(handler))
+    {
+    }
+
+    void complete(io_uring_cqe const & cqe) override {
+        std::unique_ptr<provided_receive_operation> self(this);
+
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+            handler_(cqe.res < 0 ? -cqe.res : 0, nullptr, 0);
+            return;
+        }
+
+        uint16_t const id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+
+        // The buffer goes back to the group even if the handler throws.
+        struct recycler {
+            ~recycler() { buffers.recycle(id); }
+            reactor::io_uring_buffer_group & buffers;
+            uint16_t id;
+        } recycle{ buffers_, id };
+
+        handler_(cqe.res < 0 ? -cqe.res : 0, buffers_.buffer(id), cqe.res < 0 ? 0 : cqe.res);
+    }
+
+private:
+    reactor::io_uring_buffer_group & buffers_;
+    stream_socket::provided_buffer_handler handler_;
+};
+
+
+//! \brief An accept; the peer address is written into the operation itself.
+
+class accept_operation : public reactor::io_uring_operation {
+public:
+    explicit accept_operation(stream_socket::accept_handler handler)
+        : handler_(std::move(handler))
+        , addr_()
+        , addr_length_(sizeof(addr_))
+    {
+    }
+
+    sockaddr * addr() { return reinterpret_cast<sockaddr *>(&addr_); }
+    socklen_t * addr_length() { return &addr_length_; }
+
+    void complete(io_uring_cqe const & cqe) override {
+        std::unique_ptr<accept_operation> self(this);
+
+        if (cqe.res < 0) {
+            handler_(-cqe.res, std::unique_ptr<stream_socket>(), network::socket_address());
+            return;
+        }
+
+        // As with the other errors of a completion-based operation, running out of memory is reported to the handler
+        // rather than thrown into the reactor's completion loop; the accepted descriptor is closed.
+        std::unique_ptr<stream_socket> accepted;
+        try {
+            accepted.reset(new stream_socket(cqe.res));
+        }
+        catch (std::bad_alloc const &) {
+            ::close(cqe.res);
+            handler_(ENOMEM, std::unique_ptr<stream_socket>(), network::socket_address());
+            return;
+        }
+
+        handler_(0, std::move(accepted), network::socket_address(addr(), addr_length_));
+    }
+
+private:
+    stream_socket::accept_handler handler_;
+    sockaddr_storage addr_;
+    socklen_t addr_length_;
+};
+
+}
+
+#endif /* defined(__linux__) */
+
 namespace meridian {
 namespace network {
 
@@ -31,5 +150,145 @@ std::unique_ptr<stream_socket> stream_socket::accept(socket_address & address)
     return std::unique_ptr<stream_socket>(new stream_socket(accept_fd));
 }
 
+
+stream_socket::pool::handle stream_socket::accept(socket_address & address, pool & sockets)
+{
+    sockaddr_storage addr;
+    socklen_t addr_length = sizeof(addr);
+
+    int accept_fd = ::accept(fd(), reinterpret_cast<sockaddr *>(&addr), &addr_length);
+    if (accept_fd < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("accept");
+    }
+
+    address = socket_address(reinterpret_cast<sockaddr *>(&addr), addr_length);
+
+    try {
+        return sockets.make(accept_fd);
+    }
+    catch (...) {
+        ::close(accept_fd);
+        throw;
+    }
+}
+
+#if defined(__linux__)
+
+void stream_socket::async_receive(
+        reactor::io_uring_reactor & reactor,
+        void * buffer,
+        size_t length,
+        completion_handler handler)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    std::unique_ptr<transfer_operation> operation(new transfer_operation(std::move(handler)));
+    io_uring_sqe * sqe = reactor.prepare(*operation);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd();
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = length;
+    operation.release();
+}
+
+
+void stream_socket::async_receive(
+        reactor::io_uring_reactor & reactor,
+        reactor::io_uring_buffer_group & buffers,
+        provided_buffer_handler handler)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    std::unique_ptr<provided_receive_operation> operation(new provided_receive_operation(buffers, std::move(handler)));
+    io_uring_sqe * sqe = reactor.prepare(*operation);
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd();
+    sqe->len = buffers.buffer_size();
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = buffers.id();
+    operation.release();
+}
+
+
+void stream_socket::async_send(
+        reactor::io_uring_reactor & reactor,
+        void const * buffer,
+        size_t length,
+        completion_handler handler)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    std::unique_ptr<transfer_operation> operation(new transfer_operation(std::move(handler)));
+    io_uring_sqe * sqe = reactor.prepare(*operation);
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd();
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = length;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    operation.release();
+}
+
+
+void stream_socket::async_accept(reactor::io_uring_reactor & reactor, accept_handler handler)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    std::unique_ptr<accept_operation> operation(new accept_operation(std::move(handler)));
+    io_uring_sqe * sqe = reactor.prepare(*operation);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd();
+    sqe->addr = reinterpret_cast<uint64_t>(operation->addr());
+    sqe->addr2 = reinterpret_cast<uint64_t>(operation->addr_length());
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    operation.release();
+}
+
+
+size_t stream_socket::send_file(int file_fd, off_t & offset, size_t length)
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        throw invalid_socket_exception();
+    }
+
+    io_result result = send_file(file_fd, offset, length, std::nothrow);
+    if (!result.ok()) {
+        throw exception()
+            << boost::errinfo_errno(result.error())
+            << boost::errinfo_api_function("sendfile");
+    }
+
+    return result.bytes();
+}
+
+
+io_result stream_socket::send_file(int file_fd, off_t & offset, size_t length, std::nothrow_t const &) noexcept
+{
+    if (fd() == INVALID_SOCKET_FD) {
+        return io_result::failure(EBADF);
+    }
+
+    for (;;) {
+        ssize_t result = ::sendfile(fd(), file_fd, &offset, length);
+        if (result >= 0) {
+            return io_result::success(result);
+        }
+        if (errno != EINTR) {
+            return io_result::failure(errno);
+        }
+    }
+}
+
+#endif /* defined(__linux__) */
+
 } // namespace network
 } // namespace meridian
@@ -0,0 +1,156 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/network/zerocopy_sender.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+
+namespace meridian {
+namespace network {
+
+size_t const zerocopy_sender::THRESHOLD;
+
+
+zerocopy_sender::zerocopy_sender(stream_socket & socket)
+    : socket_(socket)
+    , enabled_(false)
+    , next_(0)
+    , records_()
+{
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    int const value = 1;
+    enabled_ = ::setsockopt(socket.fd(), SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value)) == 0;
+#endif
+}
+
+
+io_result zerocopy_sender::send(void const * buffer, size_t length, completion && on_complete, int flags)
+{
+    char const * data = static_cast<char const *>(buffer);
+    uint64_t const first = next_;
+    bool zerocopy = enabled_ && length >= THRESHOLD;
+    bool copied = false;
+    size_t sent = 0;
+    io_result result = io_result::success(0);
+
+    while (sent < length) {
+#if defined(MSG_ZEROCOPY)
+        int const send_flags = zerocopy ? flags | MSG_ZEROCOPY : flags;
+#else
+        int const send_flags = flags;
+#endif
+        result = socket_.send(data + sent, length - sent, send_flags, std::nothrow);
+        if (!result.ok()) {
+            if (zerocopy && result.error() == ENOBUFS) {
+                // Out of memory for notifications; copy instead.
+                zerocopy = false;
+                continue;
+            }
+            break;
+        }
+
+        if (zerocopy) {
+            ++next_;
+        }
+        else {
+            copied = true;
+        }
+        sent += result.bytes();
+    }
+
+    if (sent == 0) {
+        return result;
+    }
+
+    records_.push_back(record{ first, next_, next_ - first, copied, std::move(on_complete) });
+    deliver();
+
+    return io_result::success(sent);
+}
+
+
+size_t zerocopy_sender::reap()
+{
+    for (;;) {
+        union {
+            cmsghdr header;
+            char buffer[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        } control;
+
+        msghdr message = msghdr();
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+
+        if (!socket_.receive_message(message, MSG_ERRQUEUE, std::nothrow).ok()) {
+            break;
+        }
+
+        for (cmsghdr * header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            bool const is_error = (header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR)
+                || (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR);
+            if (!is_error) {
+                continue;
+            }
+
+            sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+            if (error.ee_errno == 0 && error.ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                release(error.ee_info, error.ee_data, error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+            }
+        }
+    }
+
+    return deliver();
+}
+
+
+void zerocopy_sender::release(uint32_t low, uint32_t high, bool copied) noexcept
+{
+    // Every outstanding send is numbered within 2^32 of the oldest, so the kernel's numbers extend unambiguously.
+    uint64_t const base = records_.empty() ? next_ : records_.front().first;
+    uint64_t const first = base + static_cast<uint32_t>(low - static_cast<uint32_t>(base));
+    uint64_t const end = first + static_cast<uint32_t>(high - low) + 1;
+
+    for (record & r : records_) {
+        if (r.first >= end) {
+            break;
+        }
+        if (r.end <= first || r.outstanding == 0) {
+            continue;
+        }
+
+        r.outstanding -= std::min(r.end, end) - std::max(r.first, first);
+        r.copied = r.copied || copied;
+    }
+}
+
+
+size_t zerocopy_sender::deliver()
+{
+    size_t delivered = 0;
+
+    while (!records_.empty() && records_.front().outstanding == 0) {
+        completion on_complete = std::move(records_.front().on_complete);
+        bool const copied = records_.front().copied;
+        records_.pop_front();
+
+        if (on_complete) {
+            on_complete(copied);
+        }
+        ++delivered;
+    }
+
+    return delivered;
+}
+
+} // namespace network
+} // namespace meridian
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,151 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/adaptive_receiver.hpp"
+
+#include <string>
+
+using meridian::network::adaptive_receiver;
+using meridian::network::io_result;
+using meridian::network::receive_buffer_pool;
+using meridian::network::stream_socket;
+
+BOOST_AUTO_TEST_SUITE(adaptive_receiver_tests)
+
+BOOST_AUTO_TEST_CASE(test_pool_size_classes)
+{
+    receive_buffer_pool pool(1);
+
+    BOOST_CHECK_EQUAL(receive_buffer_pool::size_class(1), 0u);
+    BOOST_CHECK_EQUAL(receive_buffer_pool::size_class(513), 1u);
+    BOOST_CHECK_EQUAL(receive_buffer_pool::size_class(1 << 20), receive_buffer_pool::CLASSES - 1);
+
+    char * data;
+    {
+        receive_buffer_pool::buffer first = pool.acquire(3000);
+        receive_buffer_pool::buffer second = pool.acquire(4096);
+        BOOST_CHECK_EQUAL(first.size(), 4096u);
+        BOOST_CHECK_EQUAL(pool.outstanding(), 2u);
+        data = second.data();
+    }
+
+    // One of each class is kept: second, returned first. first found no room and was freed.
+    BOOST_CHECK_EQUAL(pool.outstanding(), 0u);
+    BOOST_CHECK_EQUAL(pool.idle(), 1u);
+    receive_buffer_pool::buffer reused = pool.acquire(2049);
+    BOOST_CHECK(reused.data() == data);
+    BOOST_CHECK_EQUAL(pool.idle(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_prediction_grows_fast_and_shrinks_slowly)
+{
+    adaptive_receiver receiver(2048, 512, 65536, false);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 2048u);
+
+    receiver.record(2048);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 4096u);
+    receiver.record(4096);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 8192u);
+
+    // A single short read doesn't shrink the buffer; a run of them does, one step at a time.
+    receiver.record(100);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 8192u);
+    size_t reads = 1;
+    while (receiver.next_size() > 512) {
+        size_t const before = receiver.next_size();
+        receiver.record(100);
+        BOOST_REQUIRE(receiver.next_size() == before || receiver.next_size() == before / 2);
+        BOOST_REQUIRE(++reads < 100);
+    }
+    BOOST_CHECK(reads > 4);
+
+    receiver.hint(1 << 20);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 65536u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_receive_holds_no_buffer_between_reads)
+{
+    receive_buffer_pool pool;
+    int fds[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    stream_socket first(fds[0]);
+    stream_socket second(fds[1]);
+    second.set_non_blocking(true);
+
+    std::string data(20000, 'd');
+    BOOST_REQUIRE_EQUAL(first.send(data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+
+    adaptive_receiver receiver(512);
+    std::string received;
+    auto sink = [&] (char const * bytes, size_t length) {
+        BOOST_CHECK_EQUAL(pool.outstanding(), 1u);
+        received.append(bytes, length);
+    };
+
+    // The first read fills its buffer; FIONREAD then sizes the second to take the rest.
+    io_result result = receiver.receive(second, sink, pool);
+    BOOST_REQUIRE(result.ok());
+    BOOST_CHECK_EQUAL(result.bytes(), 512u);
+    BOOST_CHECK_EQUAL(receiver.next_size(), 32768u);
+    BOOST_CHECK_EQUAL(pool.outstanding(), 0u);
+
+    result = receiver.receive(second, sink, pool);
+    BOOST_REQUIRE(result.ok());
+    BOOST_CHECK(received == data);
+
+    result = receiver.receive(second, sink, pool);
+    BOOST_CHECK(result.would_block());
+    BOOST_CHECK_EQUAL(pool.outstanding(), 0u);
+
+    first.close();
+    second.close();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_maximum_clamped_to_largest_buffer)
+{
+    size_t const largest = receive_buffer_pool::class_size(receive_buffer_pool::CLASSES - 1);
+    receive_buffer_pool pool;
+    int fds[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    stream_socket first(fds[0]);
+    stream_socket second(fds[1]);
+    first.set_non_blocking(true);
+    second.set_non_blocking(true);
+
+    adaptive_receiver receiver(1 << 20, 512, 1 << 20, false);
+    BOOST_CHECK_EQUAL(receiver.next_size(), largest);
+    receiver.hint(1 << 20);
+    BOOST_CHECK_EQUAL(receiver.next_size(), largest);
+
+    // However much is queued, no read is larger than the buffer it goes into.
+    std::string data(4 * largest, 'd');
+    size_t sent = 0;
+    while (sent < data.size()) {
+        io_result const result = first.send(data.data() + sent, data.size() - sent, 0, std::nothrow);
+        if (!result.ok()) {
+            break;
+        }
+        sent += result.bytes();
+    }
+
+    std::string received;
+    auto sink = [&] (char const * bytes, size_t length) {
+        BOOST_CHECK(length <= largest);
+        received.append(bytes, length);
+    };
+    io_result result = receiver.receive(second, sink, pool);
+    BOOST_REQUIRE(result.ok());
+    BOOST_CHECK(result.bytes() <= largest);
+    BOOST_CHECK_EQUAL(receiver.next_size(), largest);
+
+    first.close();
+    second.close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
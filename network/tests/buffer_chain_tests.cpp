@@ -0,0 +1,146 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/buffer_chain.hpp"
+
+#include <string>
+#include <vector>
+
+using meridian::network::buffer_chain;
+using meridian::network::io_result;
+using meridian::network::stream_socket;
+
+namespace {
+
+std::string contents(buffer_chain const & chain)
+{
+    std::string result(chain.size(), '\0');
+    BOOST_REQUIRE_EQUAL(chain.copy_out(&result[0], result.size()), result.size());
+    return result;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(buffer_chain_tests)
+
+BOOST_AUTO_TEST_CASE(test_append_consume_releases_segments)
+{
+    buffer_chain::segment_pool pool;
+    buffer_chain chain(pool);
+
+    std::string data(buffer_chain::SEGMENT_SIZE * 2 + 100, 'x');
+    chain.append(data.data(), data.size());
+    BOOST_CHECK_EQUAL(chain.size(), data.size());
+    BOOST_CHECK_EQUAL(chain.segment_count(), 3u);
+    BOOST_CHECK_EQUAL(pool.size(), 3u);
+
+    chain.consume(buffer_chain::SEGMENT_SIZE + 1);
+    BOOST_CHECK_EQUAL(chain.size(), data.size() - buffer_chain::SEGMENT_SIZE - 1);
+    BOOST_CHECK_EQUAL(pool.size(), 2u);
+
+    chain.consume(chain.size());
+    BOOST_CHECK(chain.empty());
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_prepend_and_references)
+{
+    buffer_chain::segment_pool pool;
+    buffer_chain chain(pool);
+
+    std::string body(buffer_chain::SEGMENT_SIZE, 'b');
+    bool released = false;
+    chain.append_reference(body.data(), body.size(), [&] { released = true; });
+    chain.append("\r\n", 2);
+    chain.prepend("200 OK\r\n", 8);
+    chain.prepend("HTTP/1.1 ", 9);
+
+    BOOST_CHECK_EQUAL(chain.segment_count(), 3u);
+    BOOST_CHECK(contents(chain) == "HTTP/1.1 200 OK\r\n" + body + "\r\n");
+
+    chain.consume(17 + body.size() - 1);
+    BOOST_CHECK(!released);
+    chain.consume(1);
+    BOOST_CHECK(released);
+    BOOST_CHECK_EQUAL(contents(chain), "\r\n");
+
+    buffer_chain other(pool);
+    other.append("head", 4);
+    chain.prepend(std::move(other));
+    BOOST_CHECK(other.empty());
+    BOOST_CHECK_EQUAL(contents(chain), "head\r\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_find_across_segments)
+{
+    buffer_chain::segment_pool pool;
+    buffer_chain chain(pool);
+
+    std::string filler(buffer_chain::SEGMENT_SIZE - 2, 'a');
+    chain.append(filler.data(), filler.size());
+    chain.append("\r\n\r\nbody", 8);
+    chain.append_reference("\r\n\r", 3);
+    chain.append("\n", 1);
+
+    BOOST_CHECK_EQUAL(chain.find("\r\n\r\n", 4), filler.size());
+    BOOST_CHECK_EQUAL(chain.find("\r\n\r\n", 4, filler.size() + 1), filler.size() + 8);
+    BOOST_CHECK_EQUAL(chain.find("body\r", 5), filler.size() + 4);
+    BOOST_CHECK_EQUAL(chain.find("missing", 7), buffer_chain::npos);
+
+    char peeked[6];
+    BOOST_CHECK_EQUAL(chain.copy_out(peeked, sizeof(peeked), filler.size() - 1), sizeof(peeked));
+    BOOST_CHECK_EQUAL(std::string(peeked, sizeof(peeked)), "a\r\n\r\nb");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_socket_round_trip)
+{
+    buffer_chain::segment_pool pool;
+    int fds[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    stream_socket first(fds[0]);
+    stream_socket second(fds[1]);
+    first.set_non_blocking(true);
+    second.set_non_blocking(true);
+
+    std::string data;
+    for (size_t index = 0; index < 3 * buffer_chain::SEGMENT_SIZE; ++index) {
+        data.push_back(static_cast<char>('a' + index % 26));
+    }
+
+    {
+        buffer_chain output(pool);
+        buffer_chain input(pool);
+        output.append(data.data(), 1000);
+        output.append_reference(data.data() + 1000, data.size() - 1000);
+
+        while (!output.empty()) {
+            BOOST_REQUIRE(output.write_to(first).ok());
+        }
+
+        io_result result = input.read_from(second, data.size());
+        BOOST_REQUIRE(result.ok());
+        while (input.size() < data.size()) {
+            result = input.read_from(second, data.size() - input.size());
+            BOOST_REQUIRE(result.ok());
+        }
+
+        BOOST_CHECK(contents(input) == data);
+        BOOST_CHECK_EQUAL(input.segment_count(), 3u);
+
+        result = input.read_from(second);
+        BOOST_CHECK(result.would_block());
+        BOOST_CHECK_EQUAL(input.segment_count(), 3u);
+    }
+
+    BOOST_CHECK_EQUAL(pool.size(), 0u);
+    first.close();
+    second.close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
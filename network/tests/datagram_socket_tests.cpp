@@ -0,0 +1,157 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/datagram_socket.hpp"
+
+#include <string>
+#include <vector>
+
+using meridian::network::datagram;
+using meridian::network::datagram_socket;
+using meridian::network::io_result;
+using meridian::network::ip_address;
+using meridian::network::socket_address;
+using meridian::network::socket_domain;
+
+BOOST_AUTO_TEST_SUITE(datagram_socket_tests)
+
+BOOST_AUTO_TEST_CASE(test_send_and_receive_batch)
+{
+    socket_address const loopback = socket_address::create_inet_address(ip_address("127.0.0.1"), 0);
+
+    datagram_socket receiver(socket_domain::inet);
+    receiver.bind(loopback);
+    receiver.set_non_blocking(true);
+    socket_address const destination = receiver.address();
+
+    datagram_socket sender(socket_domain::inet);
+    sender.bind(loopback);
+
+    // More than one system call's worth, to cover the chunking.
+    size_t const COUNT = datagram_socket::MAX_BATCH + 36;
+    std::vector<std::string> payloads(COUNT);
+    std::vector<datagram> outgoing(COUNT);
+    for (size_t index = 0; index < COUNT; ++index) {
+        payloads[index] = "datagram " + std::to_string(index);
+        outgoing[index].buffer = &payloads[index][0];
+        outgoing[index].length = payloads[index].size();
+        outgoing[index].address = destination;
+    }
+
+    BOOST_CHECK_EQUAL(sender.send_batch(outgoing.data(), COUNT), COUNT);
+
+    std::vector<std::vector<char>> buffers(COUNT, std::vector<char>(64));
+    std::vector<datagram> incoming(COUNT);
+    for (size_t index = 0; index < COUNT; ++index) {
+        incoming[index].buffer = buffers[index].data();
+        incoming[index].capacity = buffers[index].size();
+    }
+
+    io_result result = receiver.receive_batch(incoming.data(), COUNT, 0, std::nothrow);
+    BOOST_REQUIRE(result.ok());
+    BOOST_REQUIRE_EQUAL(result.bytes(), COUNT);
+
+    for (size_t index = 0; index < COUNT; ++index) {
+        BOOST_CHECK_EQUAL(std::string(buffers[index].data(), incoming[index].length), payloads[index]);
+        BOOST_CHECK(!incoming[index].truncated);
+        BOOST_CHECK_EQUAL(incoming[index].address.port(), sender.address().port());
+    }
+
+    result = receiver.receive_batch(incoming.data(), COUNT, 0, std::nothrow);
+    BOOST_CHECK(result.would_block());
+    BOOST_CHECK_THROW(receiver.receive_batch(incoming.data(), COUNT), meridian::network::exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_receive_batch_reports_truncation)
+{
+    datagram_socket receiver(socket_domain::inet);
+    receiver.bind(socket_address::create_inet_address(ip_address("127.0.0.1"), 0));
+    receiver.set_non_blocking(true);
+
+    datagram_socket sender(socket_domain::inet);
+    sender.connect(receiver.address());
+
+    char payload[] = "longer than four";
+    datagram outgoing = datagram();
+    outgoing.buffer = payload;
+    outgoing.length = sizeof(payload);
+    BOOST_REQUIRE_EQUAL(sender.send_batch(&outgoing, 1), 1u);
+
+    char buffer[4];
+    datagram incoming = datagram();
+    incoming.buffer = buffer;
+    incoming.capacity = sizeof(buffer);
+    BOOST_REQUIRE_EQUAL(receiver.receive_batch(&incoming, 1), 1u);
+    BOOST_CHECK_EQUAL(incoming.length, sizeof(buffer));
+    BOOST_CHECK(incoming.truncated);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_segmentation_offload)
+{
+    datagram_socket receiver(socket_domain::inet);
+    receiver.bind(socket_address::create_inet_address(ip_address("127.0.0.1"), 0));
+    receiver.set_non_blocking(true);
+    receiver.set_udp_gro(true);
+    BOOST_CHECK(receiver.get_udp_gro());
+
+    datagram_socket sender(socket_domain::inet);
+    sender.bind(socket_address::create_inet_address(ip_address("127.0.0.1"), 0));
+
+    // Ten full segments and a short one.
+    size_t const SEGMENT = 100;
+    std::string payload;
+    for (char c = 'a'; c <= 'k'; ++c) {
+        payload.append(c == 'k' ? SEGMENT / 2 : SEGMENT, c);
+    }
+
+    BOOST_CHECK_EQUAL(sender.send_segmented(payload.data(), payload.size(), SEGMENT, receiver.address()),
+                      payload.size());
+
+    std::vector<std::string> datagrams;
+    std::vector<char> buffer(65536);
+    for (;;) {
+        socket_address from;
+        size_t segment_size = 0;
+        io_result result = receiver.receive_segmented(buffer.data(), buffer.size(), from, segment_size, 0,
+                                                      std::nothrow);
+        if (!result.ok()) {
+            BOOST_REQUIRE(result.would_block());
+            break;
+        }
+
+        BOOST_CHECK_EQUAL(from.port(), sender.address().port());
+        datagram_socket::for_each_segment(buffer.data(), result.bytes(), segment_size,
+                                          [&] (char const * data, size_t length) {
+            datagrams.push_back(std::string(data, length));
+        });
+    }
+
+    BOOST_REQUIRE_EQUAL(datagrams.size(), 11u);
+    for (size_t index = 0; index < datagrams.size(); ++index) {
+        BOOST_CHECK_EQUAL(datagrams[index], payload.substr(index * SEGMENT, SEGMENT));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_for_each_segment)
+{
+    char const data[] = "abcdefg";
+    std::vector<std::string> segments;
+    auto sink = [&] (char const * segment, size_t length) { segments.push_back(std::string(segment, length)); };
+
+    datagram_socket::for_each_segment(data, 7, 3, sink);
+    BOOST_REQUIRE_EQUAL(segments.size(), 3u);
+    BOOST_CHECK_EQUAL(segments[2], "g");
+
+    segments.clear();
+    datagram_socket::for_each_segment(data, 0, 0, sink);
+    BOOST_REQUIRE_EQUAL(segments.size(), 1u);
+    BOOST_CHECK(segments[0].empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/file_transfer.hpp"
+
+#include <cstdlib>
+#include <string>
+
+using meridian::network::file_transfer;
+using meridian::network::io_result;
+using meridian::network::splice_pipe_cache;
+using meridian::network::stream_socket;
+
+namespace {
+
+//! \brief An unlinked temporary file holding \a size bytes of a pattern.
+
+struct temporary_file {
+    explicit temporary_file(size_t size) {
+        char path[] = "/tmp/meridian_file_transfer_XXXXXX";
+        fd = ::mkstemp(path);
+        BOOST_REQUIRE(fd >= 0);
+        ::unlink(path);
+
+        for (size_t index = 0; index < size; ++index) {
+            contents.push_back(static_cast<char>('a' + index % 26));
+        }
+        BOOST_REQUIRE_EQUAL(::write(fd, contents.data(), size), static_cast<ssize_t>(size));
+    }
+
+    ~temporary_file() {
+        ::close(fd);
+    }
+
+    int fd;
+    std::string contents;
+};
+
+//! \brief Runs \a transfer to completion over a socket pair small enough to fill up, returning what arrived.
+
+std::string run_transfer(file_transfer & transfer, splice_pipe_cache & pipes)
+{
+    int fds[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    stream_socket sender(fds[0]);
+    stream_socket receiver(fds[1]);
+    sender.set_non_blocking(true);
+    receiver.set_non_blocking(true);
+    sender.set_send_buffer_size(4096);
+
+    std::string received;
+    char buffer[8192];
+    size_t blocked = 0;
+
+    while (!transfer.done()) {
+        io_result result = transfer.send(sender, pipes);
+        BOOST_REQUIRE(result.ok() || result.would_block());
+        if (!transfer.done()) {
+            ++blocked;
+        }
+
+        // The socket drained: the reactor's write callback would now resume the transfer.
+        for (;;) {
+            result = receiver.receive(buffer, sizeof(buffer), 0, std::nothrow);
+            if (!result.ok()) {
+                break;
+            }
+            received.append(buffer, result.bytes());
+        }
+    }
+
+    BOOST_CHECK(blocked > 0);
+    sender.close();
+    receiver.close();
+    return received;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(file_transfer_tests)
+
+BOOST_AUTO_TEST_CASE(test_sendfile)
+{
+    temporary_file file(256 * 1024);
+    splice_pipe_cache pipes;
+
+    file_transfer transfer(file.fd, 100, file.contents.size() - 100);
+    BOOST_CHECK(run_transfer(transfer, pipes) == file.contents.substr(100));
+    BOOST_CHECK_EQUAL(transfer.offset(), static_cast<off_t>(file.contents.size()));
+    BOOST_CHECK_EQUAL(pipes.size(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_splice_reuses_pipe)
+{
+    temporary_file file(256 * 1024);
+    splice_pipe_cache pipes;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        file_transfer transfer(file.fd, 0, file.contents.size(), file_transfer::method::splice);
+        BOOST_CHECK(run_transfer(transfer, pipes) == file.contents);
+        BOOST_CHECK_EQUAL(pipes.size(), 1u);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_short_file)
+{
+    temporary_file file(10);
+    splice_pipe_cache pipes;
+
+    int fds[2];
+    BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    stream_socket sender(fds[0]);
+
+    file_transfer transfer(file.fd, 0, 20);
+    io_result result = transfer.send(sender, pipes);
+    BOOST_CHECK(result.ok());
+    BOOST_CHECK_EQUAL(result.bytes(), 10u);
+
+    result = transfer.send(sender, pipes);
+    BOOST_CHECK_EQUAL(result.error(), ENODATA);
+    BOOST_CHECK_EQUAL(transfer.remaining(), 10u);
+
+    sender.close();
+    ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
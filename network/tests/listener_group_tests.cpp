@@ -0,0 +1,91 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/listener_group.hpp"
+
+#include <algorithm>
+
+using meridian::network::ip_address;
+using meridian::network::listener_group;
+using meridian::network::socket_address;
+using meridian::network::stream_socket;
+
+namespace {
+
+int connect_to(listener_group & group)
+{
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(group.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return client;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(listener_group_tests)
+
+BOOST_AUTO_TEST_CASE(test_listeners_share_address)
+{
+    listener_group group(socket_address::create_inet_address(ip_address(), 0), 3, 8);
+    BOOST_REQUIRE_EQUAL(group.size(), 3u);
+
+    in_port_t const port = group.address().port();
+    BOOST_CHECK(port != 0);
+
+    for (size_t index = 0; index < group.size(); ++index) {
+        BOOST_CHECK_EQUAL(group.at(index).address().port(), port);
+        BOOST_CHECK(group.at(index).get_reuse_port());
+        BOOST_CHECK(group.at(index).get_non_blocking());
+    }
+}
+
+#if defined(__linux__)
+
+BOOST_AUTO_TEST_CASE(test_steer_by_incoming_cpu)
+{
+    static size_t const CLIENTS = 8;
+
+    std::vector<int> const cpus = { 1, 0 };
+    listener_group group(socket_address::create_inet_address(ip_address(), 0), cpus.size(), CLIENTS);
+    group.steer_by_incoming_cpu(cpus);
+
+    std::vector<int> clients;
+    for (size_t i = 0; i < CLIENTS; ++i) {
+        clients.push_back(connect_to(group));
+    }
+
+    // Each connection must have been queued on the listener assigned to the CPU it arrived on.
+
+    size_t accepted = 0;
+    bool steered = true;
+
+    for (size_t index = 0; index < group.size(); ++index) {
+        group.at(index).accept_until_drained(
+                CLIENTS,
+                [&](std::unique_ptr<stream_socket> client, socket_address const &) {
+                    int const cpu = client->get_incoming_cpu();
+                    auto const assigned = std::find(cpus.begin(), cpus.end(), cpu);
+                    size_t const expected = assigned != cpus.end() ? assigned - cpus.begin() : cpu % cpus.size();
+
+                    steered = steered && cpu >= 0 && expected == index;
+                    ++accepted;
+                    client->close();
+                });
+    }
+
+    BOOST_CHECK_EQUAL(accepted, CLIENTS);
+    BOOST_CHECK(steered);
+
+    for (int client : clients) {
+        ::close(client);
+    }
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,213 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__)
+
+#include "meridian/network/sharded_runtime.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using meridian::network::ip_address;
+using meridian::network::sharded_runtime;
+using meridian::network::socket_address;
+using meridian::network::stream_socket;
+
+namespace {
+
+//! \brief Waits up to five seconds for \a done to return true.
+
+template <typename PREDICATE>
+bool wait_until(PREDICATE done)
+{
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(sharded_runtime_tests)
+
+BOOST_AUTO_TEST_CASE(test_shards)
+{
+    sharded_runtime runtime(3);
+    BOOST_CHECK_EQUAL(runtime.size(), 3u);
+    BOOST_CHECK(!runtime.current());
+
+    std::atomic<int> started(0);
+    std::atomic<bool> correct(true);
+
+    runtime.start([&](sharded_runtime::shard & self) {
+        if (runtime.current() != &self || &runtime.at(self.index()) != &self) {
+            correct = false;
+        }
+        ++started;
+    });
+
+    BOOST_CHECK(wait_until([&] { return started == 3; }));
+    BOOST_CHECK(correct);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_submit_to_ping_pong)
+{
+    static int const ROUNDS = 1000;
+
+    sharded_runtime runtime(2);
+    std::atomic<int> rounds(0);
+    std::atomic<bool> correct(true);
+
+    std::function<void (size_t)> bounce = [&](size_t here) {
+        if (!runtime.current() || runtime.current()->index() != here) {
+            correct = false;
+        }
+        if (++rounds < ROUNDS) {
+            runtime.submit_to(1 - here, [&bounce, here] { bounce(1 - here); });
+        }
+    };
+
+    runtime.start();
+    runtime.submit_to(0, [&] { bounce(0); });
+
+    BOOST_CHECK(wait_until([&] { return rounds == ROUNDS; }));
+    BOOST_CHECK(correct);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_overflowing_channel_keeps_order)
+{
+    static int const TASKS = 100;
+
+    sharded_runtime runtime(2, 4);
+    std::vector<int> order;
+    std::atomic<bool> done(false);
+
+    runtime.start();
+    runtime.submit_to(0, [&] {
+        for (int i = 0; i < TASKS; ++i) {
+            runtime.submit_to(1, [&order, i] { order.push_back(i); });
+        }
+        runtime.submit_to(1, [&] { done = true; });
+    });
+
+    BOOST_REQUIRE(wait_until([&] { return done.load(); }));
+    BOOST_REQUIRE_EQUAL(order.size(), size_t(TASKS));
+    for (int i = 0; i < TASKS; ++i) {
+        BOOST_CHECK_EQUAL(order[i], i);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_listeners_share_port)
+{
+    static int const CLIENTS = 8;
+
+    sharded_runtime runtime(2);
+    std::atomic<int> accepted(0);
+
+    runtime.listen(
+            socket_address::create_inet_address(ip_address(), 0),
+            CLIENTS,
+            [&](sharded_runtime::shard &, stream_socket::pool::handle client, socket_address const &) {
+                ++accepted;
+                client->close();
+            });
+
+    in_port_t const port = runtime.listen_address().port();
+    BOOST_CHECK(port != 0);
+    for (size_t index = 0; index < runtime.size(); ++index) {
+        BOOST_REQUIRE(runtime.at(index).listener());
+        BOOST_CHECK_EQUAL(runtime.at(index).listener()->address().port(), port);
+        BOOST_CHECK(runtime.at(index).listener()->get_reuse_port());
+    }
+
+    runtime.start();
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(runtime.listen_address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int clients[CLIENTS];
+    for (int & client : clients) {
+        client = ::socket(AF_INET, SOCK_STREAM, 0);
+        BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    BOOST_CHECK(wait_until([&] { return accepted == CLIENTS; }));
+
+    for (int client : clients) {
+        ::close(client);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(test_shard_survives_descriptor_exhaustion)
+{
+    sharded_runtime runtime(1);
+    std::atomic<int> accepted(0);
+    std::atomic<bool> non_blocking(true);
+
+    runtime.listen(
+            socket_address::create_inet_address(ip_address(), 0),
+            4,
+            [&](sharded_runtime::shard &, stream_socket::pool::handle client, socket_address const &) {
+                non_blocking = non_blocking && (::fcntl(client->fd(), F_GETFL) & O_NONBLOCK);
+                ++accepted;
+                client->close();
+            });
+
+    std::atomic<bool> started(false);
+    runtime.start([&](sharded_runtime::shard &) { started = true; });
+    BOOST_REQUIRE(wait_until([&] { return started.load(); }));
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(runtime.listen_address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int const client = ::socket(AF_INET, SOCK_STREAM, 0);
+    BOOST_REQUIRE(client >= 0);
+
+    // Every descriptor the process may open is taken, so the shard's accept fails with EMFILE.
+    rlimit original;
+    BOOST_REQUIRE(::getrlimit(RLIMIT_NOFILE, &original) == 0);
+    rlimit limited = original;
+    limited.rlim_cur = ::fcntl(client, F_DUPFD, 0);
+    BOOST_REQUIRE(static_cast<int>(limited.rlim_cur) >= 0);
+    ::close(static_cast<int>(limited.rlim_cur));
+    BOOST_REQUIRE(::setrlimit(RLIMIT_NOFILE, &limited) == 0);
+
+    std::vector<int> filler;
+    for (int fd; (fd = ::fcntl(client, F_DUPFD, 0)) >= 0; ) {
+        filler.push_back(fd);
+    }
+
+    BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(accepted, 0);
+
+    // Once descriptors are free again, the shard, still running, accepts the queued connection.
+    for (int fd : filler) {
+        ::close(fd);
+    }
+    BOOST_REQUIRE(::setrlimit(RLIMIT_NOFILE, &original) == 0);
+
+    BOOST_CHECK(wait_until([&] { return accepted == 1; }));
+    BOOST_CHECK(non_blocking);
+    ::close(client);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,558 @@
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/stream_socket.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include "meridian/reactor/epoll_reactor.hpp"
+#endif
+
+using meridian::network::drain_status;
+using meridian::network::iovec_cursor;
+using meridian::network::ip_address;
+using meridian::network::socket_address;
+using meridian::network::socket_domain;
+using meridian::network::stream_socket;
+
+namespace {
+
+struct connected_pair {
+    connected_pair() {
+        int fds[2];
+        BOOST_REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        first.reset(new stream_socket(fds[0]));
+        second.reset(new stream_socket(fds[1]));
+        first->set_non_blocking(true);
+        second->set_non_blocking(true);
+    }
+
+    ~connected_pair() {
+        first->close_noexcept();
+        second->close_noexcept();
+    }
+
+    std::unique_ptr<stream_socket> first;
+    std::unique_ptr<stream_socket> second;
+};
+
+}
+
+static_assert(sizeof(void *) != 8 || sizeof(stream_socket) <= meridian::core::event_source::SIZE_BUDGET,
+              "a socket must add nothing to its event_source");
+
+BOOST_AUTO_TEST_SUITE(stream_socket_tests)
+
+BOOST_AUTO_TEST_CASE(test_created_socket_has_fd)
+{
+    stream_socket socket(socket_domain::inet);
+    BOOST_CHECK_GE(socket.fd(), 0);
+    socket.close_noexcept();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_non_blocking)
+{
+    connected_pair pair;
+    BOOST_CHECK(pair.first->get_non_blocking());
+    pair.first->set_non_blocking(false);
+    BOOST_CHECK(!pair.first->get_non_blocking());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_receive_until_drained)
+{
+    connected_pair pair;
+    std::string received;
+    char buffer[4];
+    auto sink = [&](void const * data, size_t length) { received.append(static_cast<char const *>(data), length); };
+
+    auto result = pair.first->receive_until_drained(buffer, sizeof(buffer), 64, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 0u);
+
+    pair.second->send("0123456789", 10, 0);
+
+    result = pair.first->receive_until_drained(buffer, sizeof(buffer), 6, sink);
+    BOOST_CHECK(result.status == drain_status::budget_exhausted);
+    BOOST_CHECK_EQUAL(result.count, 6u);
+    BOOST_CHECK_EQUAL(received, "012345");
+
+    result = pair.first->receive_until_drained(buffer, sizeof(buffer), 64, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 4u);
+    BOOST_CHECK_EQUAL(received, "0123456789");
+
+    pair.second->shutdown_send();
+    result = pair.first->receive_until_drained(buffer, sizeof(buffer), 64, sink);
+    BOOST_CHECK(result.status == drain_status::closed);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_nothrow_send_and_receive)
+{
+    connected_pair pair;
+    char buffer[16];
+
+    meridian::network::io_result result = pair.second->receive(buffer, sizeof(buffer), 0, std::nothrow);
+    BOOST_CHECK(!result.ok());
+    BOOST_CHECK(result.would_block());
+    BOOST_CHECK_EQUAL(result.bytes(), 0u);
+    BOOST_CHECK_THROW(pair.second->receive(buffer, sizeof(buffer), 0), meridian::network::exception);
+
+    result = pair.first->send("hello", 5, 0, std::nothrow);
+    BOOST_CHECK(result.ok());
+    BOOST_CHECK_EQUAL(result.bytes(), 5u);
+    BOOST_CHECK_EQUAL(result.error(), 0);
+
+    result = pair.second->available(std::nothrow);
+    BOOST_CHECK(result.ok());
+    BOOST_CHECK_EQUAL(result.bytes(), 5u);
+
+    result = pair.second->receive(buffer, sizeof(buffer), 0, std::nothrow);
+    BOOST_CHECK(result.ok());
+    BOOST_CHECK_EQUAL(std::string(buffer, result.bytes()), "hello");
+
+    pair.first->shutdown_send();
+    result = pair.second->receive(buffer, sizeof(buffer), 0, std::nothrow);
+    BOOST_CHECK(result.ok());
+    BOOST_CHECK_EQUAL(result.bytes(), 0u);
+
+    stream_socket closed(::dup(pair.first->fd()));
+    closed.close();
+    result = closed.send("x", 1, 0, std::nothrow);
+    BOOST_CHECK(!result.ok());
+    BOOST_CHECK_EQUAL(result.error(), EBADF);
+    BOOST_CHECK_EQUAL(closed.available(std::nothrow).error(), EBADF);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_iovec_cursor_advance)
+{
+    char a[] = "head";
+    char b[] = "";
+    char c[] = "body";
+    iovec vectors[] = { { a, 4 }, { b, 0 }, { c, 4 } };
+    iovec_cursor cursor(vectors, 3);
+
+    BOOST_CHECK_EQUAL(cursor.bytes(), 8u);
+
+    cursor.advance(2);
+    BOOST_CHECK_EQUAL(cursor.count(), 3u);
+    BOOST_CHECK_EQUAL(std::string(static_cast<char *>(cursor.data()->iov_base), cursor.data()->iov_len), "ad");
+
+    cursor.advance(2);
+    BOOST_CHECK_EQUAL(cursor.count(), 1u);
+    BOOST_CHECK(cursor.data() == &vectors[2]);
+
+    cursor.advance(4);
+    BOOST_CHECK(cursor.empty());
+    BOOST_CHECK_EQUAL(cursor.bytes(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_send_and_receive_vectored)
+{
+    connected_pair pair;
+    pair.first->set_send_buffer_size(4096);
+
+    std::string header("HTTP/1.1 200 OK\r\n\r\n");
+    std::string body(256 * 1024, 'x');
+    std::string trailer("\r\n");
+    iovec vectors[] = {
+        { &header[0], header.size() },
+        { &body[0], body.size() },
+        { &trailer[0], trailer.size() },
+    };
+    iovec_cursor cursor(vectors, 3);
+
+    std::string received;
+    std::vector<char> first(7);
+    std::vector<char> second(4093);
+    size_t partial_sends = 0;
+
+    while (!cursor.empty()) {
+        meridian::network::io_result result = pair.first->send_vectored(cursor, 0, std::nothrow);
+        BOOST_REQUIRE(result.ok() || result.would_block());
+        if (!cursor.empty()) {
+            ++partial_sends;
+        }
+
+        for (;;) {
+            iovec into[] = { { &first[0], first.size() }, { &second[0], second.size() } };
+            result = pair.second->receive_vectored(into, 2, 0, std::nothrow);
+            if (!result.ok()) {
+                BOOST_REQUIRE(result.would_block());
+                break;
+            }
+            size_t const head = std::min(result.bytes(), first.size());
+            received.append(&first[0], head);
+            received.append(&second[0], result.bytes() - head);
+        }
+    }
+
+    BOOST_CHECK(partial_sends > 0);
+    BOOST_CHECK(received == header + body + trailer);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_send_message_with_ancillary_data)
+{
+    connected_pair pair;
+    int fds[2];
+    BOOST_REQUIRE(::pipe(fds) == 0);
+
+    char byte = 'f';
+    iovec vector = { &byte, 1 };
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    std::memset(&control, 0, sizeof(control));
+
+    msghdr message = msghdr();
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    cmsghdr * header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &fds[1], sizeof(int));
+
+    BOOST_CHECK_EQUAL(pair.first->send_message(message, 0), 1);
+    ::close(fds[1]);
+
+    char received = 0;
+    iovec into = { &received, 1 };
+    std::memset(&control, 0, sizeof(control));
+    message = msghdr();
+    message.msg_iov = &into;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+
+    BOOST_CHECK_EQUAL(pair.second->receive_message(message, 0), 1);
+    BOOST_CHECK_EQUAL(received, 'f');
+
+    header = CMSG_FIRSTHDR(&message);
+    BOOST_REQUIRE(header != nullptr);
+    BOOST_REQUIRE_EQUAL(header->cmsg_type, SCM_RIGHTS);
+    int passed;
+    std::memcpy(&passed, CMSG_DATA(header), sizeof(int));
+
+    BOOST_CHECK_EQUAL(::write(passed, "p", 1), 1);
+    char piped = 0;
+    BOOST_CHECK_EQUAL(::read(fds[0], &piped, 1), 1);
+    BOOST_CHECK_EQUAL(piped, 'p');
+
+    ::close(passed);
+    ::close(fds[0]);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_accept_until_drained)
+{
+    stream_socket listener(socket_domain::inet);
+    listener.bind(socket_address::create_inet_address(ip_address(), 0));
+    listener.listen(8);
+    listener.set_non_blocking(true);
+
+    size_t accepted = 0;
+    auto sink = [&](std::unique_ptr<stream_socket> client, socket_address const &) {
+        ++accepted;
+        BOOST_CHECK(::fcntl(client->fd(), F_GETFL) & O_NONBLOCK);
+        BOOST_CHECK(::fcntl(client->fd(), F_GETFD) & FD_CLOEXEC);
+        client->close();
+    };
+
+    auto result = listener.accept_until_drained(8, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 0u);
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(listener.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int clients[2];
+    for (int & client : clients) {
+        client = ::socket(AF_INET, SOCK_STREAM, 0);
+        BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    result = listener.accept_until_drained(1, sink);
+    BOOST_CHECK(result.status == drain_status::budget_exhausted);
+    BOOST_CHECK_EQUAL(result.count, 1u);
+
+    result = listener.accept_until_drained(8, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 1u);
+    BOOST_CHECK_EQUAL(accepted, 2u);
+
+    for (int client : clients) {
+        ::close(client);
+    }
+    listener.close();
+}
+
+BOOST_AUTO_TEST_CASE(test_accept_into_pool)
+{
+    stream_socket::pool sockets(4);
+    std::vector<stream_socket::pool::handle> accepted;
+
+    stream_socket listener(socket_domain::inet);
+    listener.bind(socket_address::create_inet_address(ip_address(), 0));
+    listener.listen(8);
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(listener.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int clients[3];
+    for (int & client : clients) {
+        client = ::socket(AF_INET, SOCK_STREAM, 0);
+        BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    socket_address peer;
+    accepted.push_back(listener.accept(peer, sockets));
+    BOOST_CHECK(accepted.back()->fd() >= 0);
+    BOOST_CHECK_EQUAL(sockets.size(), 1u);
+
+    listener.set_non_blocking(true);
+    auto result = listener.accept_until_drained(
+            8,
+            sockets,
+            [&](stream_socket::pool::handle client, socket_address const &) {
+                BOOST_CHECK(::fcntl(client->fd(), F_GETFL) & O_NONBLOCK);
+                BOOST_CHECK(::fcntl(client->fd(), F_GETFD) & FD_CLOEXEC);
+                accepted.push_back(std::move(client));
+            });
+
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 2u);
+    BOOST_CHECK_EQUAL(sockets.size(), 3u);
+    BOOST_CHECK_EQUAL(sockets.capacity(), 4u);
+
+    for (stream_socket::pool::handle & client : accepted) {
+        client->close();
+    }
+    accepted.clear();
+    BOOST_CHECK_EQUAL(sockets.size(), 0u);
+
+    for (int client : clients) {
+        ::close(client);
+    }
+    listener.close();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_accept_batch)
+{
+    stream_socket listener(socket_domain::inet);
+    listener.bind(socket_address::create_inet_address(ip_address(), 0));
+    listener.listen(8);
+    listener.set_non_blocking(true);
+
+    std::vector<int> accepted;
+    auto sink = [&](int fd, sockaddr const * address, socklen_t length) {
+        BOOST_CHECK_EQUAL(address->sa_family, AF_INET);
+        BOOST_CHECK_EQUAL(length, sizeof(sockaddr_in));
+        accepted.push_back(fd);
+    };
+
+    auto result = listener.accept_batch(8, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 0u);
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(listener.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int clients[3];
+    for (int & client : clients) {
+        client = ::socket(AF_INET, SOCK_STREAM, 0);
+        BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    }
+
+    result = listener.accept_batch(2, sink);
+    BOOST_CHECK(result.status == drain_status::budget_exhausted);
+    BOOST_CHECK_EQUAL(result.count, 2u);
+
+    result = listener.accept_batch(8, sink);
+    BOOST_CHECK(result.status == drain_status::drained);
+    BOOST_CHECK_EQUAL(result.count, 1u);
+    BOOST_CHECK_EQUAL(result.error, 0);
+
+    BOOST_REQUIRE_EQUAL(accepted.size(), 3u);
+    for (int fd : accepted) {
+        BOOST_CHECK(::fcntl(fd, F_GETFL) & O_NONBLOCK);
+        BOOST_CHECK(::fcntl(fd, F_GETFD) & FD_CLOEXEC);
+        ::close(fd);
+    }
+
+    for (int client : clients) {
+        ::close(client);
+    }
+    listener.close();
+
+    // Errors are returned, not thrown.
+    stream_socket unbound(socket_domain::inet);
+    result = unbound.accept_batch(8, sink);
+    BOOST_CHECK(result.status == drain_status::failed);
+    BOOST_CHECK_EQUAL(result.count, 0u);
+    BOOST_CHECK_EQUAL(result.error, EINVAL);
+    unbound.close();
+}
+
+#if defined(__linux__)
+
+BOOST_AUTO_TEST_CASE(test_receive_until_drained_edge_triggered_sees_close)
+{
+    using meridian::reactor::epoll_reactor;
+
+    epoll_reactor reactor;
+    stream_socket listener(socket_domain::inet);
+    listener.bind(socket_address::create_inet_address(ip_address(), 0));
+    listener.listen(8);
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(listener.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+
+    socket_address peer;
+    std::unique_ptr<stream_socket> server = listener.accept(peer);
+    server->set_non_blocking(true);
+
+    size_t received = 0;
+    bool closed = false;
+    char buffer[4096];
+    reactor.register_read_callback(*server, [&] {
+        auto result = server->receive_until_drained(
+                buffer, sizeof(buffer), 65536, [&](void const *, size_t length) { received += length; });
+        closed = result.status == drain_status::closed;
+    });
+    reactor.set_trigger_mode(*server, epoll_reactor::trigger_mode::edge);
+
+    // The last data and the close arrive together, so they're reported as a single edge.
+    char const data[100] = { };
+    BOOST_REQUIRE(::send(client, data, sizeof(data), 0) == static_cast<ssize_t>(sizeof(data)));
+    ::close(client);
+
+    bool timed_out = false;
+    reactor.schedule_after(std::chrono::seconds(5), [&] { timed_out = true; });
+    while (!closed && !timed_out) {
+        reactor.wait_for_events();
+    }
+
+    BOOST_CHECK(closed);
+    BOOST_CHECK_EQUAL(received, sizeof(data));
+
+    reactor.remove_read_callback(*server);
+    server->close();
+    listener.close();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_async_send_and_receive)
+{
+    meridian::reactor::io_uring_reactor reactor;
+    connected_pair pair;
+    char buffer[16] = { };
+    int sent = -1;
+    int received = -1;
+
+    pair.first->async_receive(reactor, buffer, sizeof(buffer), [&](int error, size_t bytes) {
+        BOOST_CHECK_EQUAL(error, 0);
+        received = bytes;
+    });
+    pair.second->async_send(reactor, "hello", 5, [&](int error, size_t bytes) {
+        BOOST_CHECK_EQUAL(error, 0);
+        sent = bytes;
+    });
+
+    while (sent < 0 || received < 0) {
+        reactor.wait_for_events();
+    }
+
+    BOOST_CHECK_EQUAL(sent, 5);
+    BOOST_CHECK_EQUAL(received, 5);
+    BOOST_CHECK_EQUAL(std::string(buffer, 5), "hello");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_async_receive_provided_buffer)
+{
+    meridian::reactor::io_uring_reactor reactor;
+    meridian::reactor::io_uring_buffer_group buffers(reactor, 1, 4, 64);
+    connected_pair pair;
+    std::string received;
+    bool done = false;
+
+    for (int i = 0; i < 8; ++i) {
+        pair.second->send("abc", 3, 0);
+        done = false;
+
+        pair.first->async_receive(reactor, buffers, [&](int error, char const * data, size_t bytes) {
+            BOOST_CHECK_EQUAL(error, 0);
+            received.append(data, bytes);
+            done = true;
+        });
+
+        while (!done) {
+            reactor.wait_for_events();
+        }
+    }
+
+    // More receives than buffers in the group: each buffer was recycled after its handler returned.
+    BOOST_CHECK_EQUAL(received, "abcabcabcabcabcabcabcabc");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_async_accept_coexists_with_callbacks)
+{
+    meridian::reactor::io_uring_reactor reactor;
+    stream_socket listener(socket_domain::inet);
+    listener.bind(socket_address::create_inet_address(ip_address(), 0));
+    listener.listen(8);
+
+    std::unique_ptr<stream_socket> accepted;
+    listener.async_accept(reactor, [&](int error, std::unique_ptr<stream_socket> client, socket_address const &) {
+        BOOST_CHECK_EQUAL(error, 0);
+        accepted = std::move(client);
+    });
+
+    sockaddr_in addr = *reinterpret_cast<sockaddr_in const *>(listener.address().addr());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    BOOST_REQUIRE(::connect(client, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+
+    while (!accepted) {
+        reactor.wait_for_events();
+    }
+
+    // Like accept_batch(), and unlike accept(), the connection is ready to be driven by a reactor.
+    BOOST_CHECK(::fcntl(accepted->fd(), F_GETFL) & O_NONBLOCK);
+    BOOST_CHECK(::fcntl(accepted->fd(), F_GETFD) & FD_CLOEXEC);
+
+    // A readiness callback on the accepted socket, driven by the same reactor.
+    bool readable = false;
+    reactor.register_read_callback(*accepted, [&] { readable = true; });
+    BOOST_REQUIRE(::send(client, "x", 1, 0) == 1);
+
+    while (!readable) {
+        reactor.wait_for_events();
+    }
+    reactor.remove_read_callback(*accepted);
+
+    ::close(client);
+    accepted->close();
+    listener.close();
+}
+
+#endif /* defined(__linux__) */
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/network/zerocopy_sender.hpp"
+
+#include <poll.h>
+#include <vector>
+
+using meridian::network::io_result;
+using meridian::network::ip_address;
+using meridian::network::socket_address;
+using meridian::network::socket_domain;
+using meridian::network::stream_socket;
+using meridian::network::zerocopy_sender;
+
+namespace {
+
+//! \brief A TCP connection over loopback; \c MSG_ZEROCOPY isn't supported on \c AF_UNIX sockets.
+
+struct tcp_pair {
+    tcp_pair() {
+        stream_socket listener(socket_domain::inet);
+        listener.bind(socket_address::create_inet_address(ip_address("127.0.0.1"), 0));
+        listener.listen(1);
+
+        client.reset(new stream_socket(socket_domain::inet));
+        socket_address const address = listener.address();
+        BOOST_REQUIRE(::connect(client->fd(), address.addr(), address.length()) == 0);
+
+        socket_address peer;
+        server = listener.accept(peer);
+        listener.close();
+        client->set_non_blocking(true);
+        server->set_non_blocking(true);
+    }
+
+    ~tcp_pair() {
+        client->close_noexcept();
+        server->close_noexcept();
+    }
+
+    std::unique_ptr<stream_socket> client;
+    std::unique_ptr<stream_socket> server;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(zerocopy_sender_tests)
+
+BOOST_AUTO_TEST_CASE(test_completions_in_order)
+{
+    tcp_pair pair;
+    zerocopy_sender sender(*pair.client);
+
+    std::vector<char> large(64 * 1024, 'z');
+    char small[] = "small";
+    std::vector<int> completed;
+    std::vector<bool> copies;
+
+    io_result result = sender.send(large.data(), large.size(), [&] (bool copied) {
+        completed.push_back(1);
+        copies.push_back(copied);
+    });
+    BOOST_REQUIRE(result.ok());
+    BOOST_REQUIRE_EQUAL(result.bytes(), large.size());
+
+    // A small buffer is copied, but its completion still waits for the large one's.
+    result = sender.send(small, sizeof(small), [&] (bool copied) {
+        completed.push_back(2);
+        copies.push_back(copied);
+    });
+    BOOST_REQUIRE(result.ok());
+    BOOST_CHECK_EQUAL(completed.size(), sender.enabled() ? 0u : 2u);
+
+    std::vector<char> buffer(large.size() + sizeof(small));
+    size_t received = 0;
+    while (received < buffer.size()) {
+        pollfd fd = { pair.server->fd(), POLLIN, 0 };
+        BOOST_REQUIRE(::poll(&fd, 1, 1000) == 1);
+        result = pair.server->receive(&buffer[received], buffer.size() - received, 0, std::nothrow);
+        BOOST_REQUIRE(result.ok());
+        received += result.bytes();
+    }
+
+    while (sender.pending()) {
+        pollfd fd = { pair.client->fd(), 0, 0 };
+        BOOST_REQUIRE(::poll(&fd, 1, 1000) == 1);
+        BOOST_REQUIRE(fd.revents & POLLERR);
+        sender.reap();
+    }
+
+    BOOST_REQUIRE_EQUAL(completed.size(), 2u);
+    BOOST_CHECK_EQUAL(completed[0], 1);
+    BOOST_CHECK_EQUAL(completed[1], 2);
+
+    // Loopback always copies, and says so.
+    BOOST_CHECK(copies[0]);
+    BOOST_CHECK(copies[1]);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_nothing_sent_keeps_completion)
+{
+    tcp_pair pair;
+    zerocopy_sender sender(*pair.client);
+    pair.client->shutdown_send();
+
+    bool called = false;
+    zerocopy_sender::completion on_complete = [&] (bool) { called = true; };
+    std::vector<char> large(zerocopy_sender::THRESHOLD, 'z');
+
+    io_result result = sender.send(large.data(), large.size(), std::move(on_complete), MSG_NOSIGNAL);
+    BOOST_CHECK_EQUAL(result.error(), EPIPE);
+    BOOST_CHECK(static_cast<bool>(on_complete));
+    BOOST_CHECK(!called);
+    BOOST_CHECK_EQUAL(sender.pending(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__epoll_reactor__hpp
+#define meridian__reactor__epoll_reactor__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/event_source_registry.hpp"
+#include "meridian/reactor/post_queue.hpp"
+#include "meridian/reactor/scoped_registration.hpp"
+#include "meridian/reactor/timer_wheel.hpp"
+#include "meridian/reactor/trigger_mode.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <sys/epoll.h>
+#include <vector>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A reactor built on Linux's \c epoll (7).
+//! \class epoll_reactor epoll_reactor.hpp meridian/reactor/epoll_reactor.hpp
+//!
+//! The registration interface is identical to select_reactor's, so the two may be used interchangeably (e.g., with
+//! scoped_registration). Unlike select_reactor, there's no \c FD_SETSIZE ceiling and wait_for_events() only touches
+//! those file descriptors which are actually ready.
+//!
+//! Interest changes aren't passed to the kernel as they're made. Instead, the file descriptor is marked dirty and all
+//! pending changes are flushed at the start of the next wait_for_events(). Registering both a readable and a writable
+//! callback for one event_source therefore costs a single \c epoll_ctl (2), as does registering and then removing a
+//! callback within the same dispatch pass (which costs none at all).
+//!
+//! Registrations are level-triggered by default. An event_source may opt into edge-triggered notification with
+//! set_trigger_mode(), in which case its callbacks are only invoked when new data (or space) arrives. A callback using
+//! edge-triggered mode must either drain the descriptor until \c EAGAIN (see, e.g., stream_socket's
+//! receive_until_drained()) or call rearm() when it stops short, or it won't be called again.
+//!
+//! \author Eric Crampton
+
+class epoll_reactor {
+public:
+    //! \brief How readiness is reported for an event_source; trigger_mode::edge corresponds to \c EPOLLET.
+    typedef reactor::trigger_mode trigger_mode;
+
+    epoll_reactor();
+    epoll_reactor(std::unique_ptr<core::abstract_event_source_registry> registry);
+    ~epoll_reactor();
+
+    epoll_reactor(epoll_reactor const & reactor) = delete;
+    epoll_reactor & operator=(epoll_reactor const & reactor) = delete;
+
+    template <event_type EVENT_TYPE>
+    using scoped_registration = reactor::scoped_registration<epoll_reactor, EVENT_TYPE>;
+
+    void register_read_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_write_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_except_callback(core::event_source & source, core::event_source::event_callback callback);
+
+    void remove_read_callback(core::event_source & source);
+    void remove_write_callback(core::event_source & source);
+    void remove_except_callback(core::event_source & source);
+
+    //! \brief Registers a unified handler, called once per wakeup with all of \a source's ready events of interest.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param handler - the handler
+    //! \param interest - the events to monitor; may be changed cheaply later with set_interest()
+    //!
+    //! No per-event callbacks may be registered on \a source at the same time.
+
+    void register_handler(
+            core::event_source & source,
+            core::event_source::event_handler handler,
+            core::event_source::event_mask interest);
+
+    //! \brief Changes the events monitored for an event_source with a unified handler.
+
+    void set_interest(core::event_source & source, core::event_source::event_mask interest);
+
+    //! \brief Removes the unified handler for an event_source.
+
+    void remove_handler(core::event_source & source);
+
+    //! \brief Identifies a timer scheduled with schedule_after() or schedule_at().
+    typedef timer_wheel::timer_id timer_id;
+
+    //! \brief The clock timer deadlines are measured against.
+    typedef timer_wheel::clock clock;
+
+    //! \brief Schedules \a callback to be called by wait_for_events() once \a delay has elapsed.
+    //!
+    //! Timers are kept in a timer_wheel: scheduling and cancellation are O(1), each wait is bounded by the nearest
+    //! deadline, and all expired timers are called together after that wait's I/O callbacks.
+
+    timer_id schedule_after(clock::duration delay, timer_wheel::timer_callback callback);
+
+    //! \brief Schedules \a callback to be called by wait_for_events() once \a deadline has passed.
+
+    timer_id schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback);
+
+    //! \brief Cancels a timer; returns false if it has already expired or been cancelled.
+
+    bool cancel(timer_id timer);
+
+    //! \brief Queues \a callback to be called by wait_for_events(). May be called from any thread.
+    //!
+    //! This is the only member function which may be called from a thread other than the one running
+    //! wait_for_events(). Callbacks are queued without a lock, and a wait is only interrupted when the queue was empty,
+    //! so posting is cheap even at high rates. See post_queue.
+
+    void post(post_queue::posted_callback callback);
+
+    //! \brief Selects level- or edge-triggered notification for an event_source.
+    //!
+    //! \param source - the event_source
+    //! \param mode - the trigger mode
+    //!
+    //! The mode applies to all of the event_source's callbacks and is reset to trigger_mode::level once its last
+    //! callback is removed. It may be set before or after registering callbacks.
+
+    void set_trigger_mode(core::event_source & source, trigger_mode mode);
+
+    //! \brief Requests a fresh notification for an edge-triggered event_source which is still ready.
+    //!
+    //! \param source - an event_source with at least one registered callback
+    //!
+    //! Use this when a callback deliberately stops before \c EAGAIN (e.g., because its budget was exhausted): the
+    //! interest set is re-submitted on the next wait_for_events(), which makes the kernel report the event_source again
+    //! if it's still ready.
+
+    void rearm(core::event_source & source);
+
+    void wait_for_events();
+
+private:
+    //! \brief Records that the interest set for \a fd may differ from what the kernel knows.
+
+    inline void mark_dirty(int fd);
+
+    //! \brief Like mark_dirty(int), but also resets per-fd options once \a source has no callbacks left, and forces
+    //! any later registration on the descriptor to be re-submitted.
+
+    inline void mark_dirty_after_remove(core::event_source & source);
+
+    //! \brief Returns the \c epoll events corresponding to the interest set of \a source.
+
+    inline static uint32_t interest_mask(core::event_source const & source);
+
+    //! \brief Returns the events a unified handler is told about for the given ready \a events.
+
+    inline static core::event_source::event_mask ready_mask(uint32_t events);
+
+    //! \brief Returns the \c epoll events that \a fd should be registered with in the kernel.
+
+    inline uint32_t desired_events(int fd) const;
+
+    //! \brief Passes all interest changes made since the last call to the kernel, one \c epoll_ctl per fd.
+
+    void flush_interest_changes();
+
+    //! \brief Calls \c epoll_ctl (2), tolerating a kernel view which has drifted due to a closed descriptor.
+
+    void control(int fd, uint32_t current, uint32_t desired);
+
+private:
+    //! \brief Per-fd bookkeeping, indexed by file descriptor.
+    struct fd_state {
+        uint32_t kernel_events; //!< the events last passed to \c epoll_ctl, or 0 if not in the interest list
+        bool dirty;             //!< true if \a fd is on the dirty list
+        bool edge_triggered;    //!< true if trigger_mode::edge was requested
+        bool rearm;             //!< true if the interest set must be re-submitted even if unchanged
+    };
+
+    post_queue posted_;               //!< declared first, to outlive registry_, in which its source is registered
+    std::unique_ptr<core::abstract_event_source_registry> registry_;
+    int epoll_fd_;
+    std::vector<fd_state> fd_states_;
+    std::vector<int> dirty_fds_;
+    std::vector<epoll_event> events_;
+    timer_wheel timers_;
+};
+
+#include "meridian/reactor/epoll_reactor.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__epoll_reactor__hpp */
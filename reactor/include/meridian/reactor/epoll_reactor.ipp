@@ -0,0 +1,57 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+void epoll_reactor::mark_dirty(int fd)
+{
+    assert(fd >= 0);
+
+    if (static_cast<size_t>(fd) >= fd_states_.size()) {
+        fd_states_.resize(std::max(static_cast<size_t>(fd) + 1, fd_states_.size() * 2), fd_state{ 0, false, false, false });
+    }
+
+    if (!fd_states_[fd].dirty) {
+        fd_states_[fd].dirty = true;
+        dirty_fds_.push_back(fd);
+    }
+}
+
+
+uint32_t epoll_reactor::interest_mask(core::event_source const & source)
+{
+    core::event_source::event_mask const interest = source.interest();
+
+    return (interest & core::event_source::READABLE  ? EPOLLIN  : 0)
+         | (interest & core::event_source::WRITABLE  ? EPOLLOUT : 0)
+         | (interest & core::event_source::EXCEPTION ? EPOLLPRI : 0);
+}
+
+
+core::event_source::event_mask epoll_reactor::ready_mask(uint32_t events)
+{
+    return (events & (EPOLLIN | EPOLLHUP | EPOLLERR) ? core::event_source::READABLE  : 0)
+         | (events & (EPOLLOUT | EPOLLERR)           ? core::event_source::WRITABLE  : 0)
+         | (events & EPOLLPRI                        ? core::event_source::EXCEPTION : 0);
+}
+
+
+void epoll_reactor::mark_dirty_after_remove(core::event_source & source)
+{
+    mark_dirty(source.fd());
+
+    if (!source.has_callback()) {
+        // The descriptor may now be closed and reused before the next flush, and closing it removed it from the
+        // kernel's interest list; a new registration with the same interest must still be submitted.
+        fd_states_[source.fd()].edge_triggered = false;
+        fd_states_[source.fd()].rearm = true;
+    }
+}
+
+
+uint32_t epoll_reactor::desired_events(int fd) const
+{
+    core::event_source const * source = registry_->find(fd);
+    uint32_t const interest = source ? interest_mask(*source) : 0;
+
+    return interest && fd_states_[fd].edge_triggered ? interest | EPOLLET : interest;
+}
@@ -12,6 +12,8 @@ namespace reactor {
 
 class exception : public virtual core::exception { };
 
+class unsupported_operation_exception : public virtual core::unsupported_operation_exception, public virtual exception { };
+
 } // namespace reactor
 } // namespace meridian
 
@@ -0,0 +1,82 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__io_uring_buffer_group__hpp
+#define meridian__reactor__io_uring_buffer_group__hpp
+
+#if defined(__linux__)
+
+#include "meridian/reactor/io_uring_reactor.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A group of equally sized receive buffers which the kernel picks from as data arrives.
+//! \class io_uring_buffer_group io_uring_buffer_group.hpp meridian/reactor/io_uring_buffer_group.hpp
+//!
+//! Wraps an \c io_uring provided-buffer group. Rather than dedicating a buffer to each pending receive, a receive
+//! submitted with \c IOSQE_BUFFER_SELECT and this group's id() is given a buffer only once data is actually available;
+//! the completion names the buffer chosen. Idle connections therefore hold no buffer at all.
+//!
+//! Buffers are provided with \c IORING_OP_PROVIDE_BUFFERS (Linux 5.7 and later). Handing a buffer back with recycle()
+//! queues such a request, which is submitted in the same batch as the reactor's other work, so recycling costs no
+//! system call of its own. A buffer belongs to the caller from its completion until it's recycled.
+//!
+//! \author Eric Crampton
+
+class io_uring_buffer_group {
+public:
+    //! \brief Allocates the buffers and provides them to a reactor's ring.
+    //!
+    //! \param reactor - the reactor whose receives will use this group; it must outlive the group
+    //! \param id - buffer group id, unique within \a reactor
+    //! \param count - number of buffers, at most 65536
+    //! \param buffer_size - size of each buffer, in bytes
+
+    io_uring_buffer_group(io_uring_reactor & reactor, uint16_t id, unsigned count, size_t buffer_size);
+
+    //! \brief Withdraws the buffers from the kernel and frees them.
+    //!
+    //! No receive using this group may be pending.
+
+    ~io_uring_buffer_group();
+
+    io_uring_buffer_group(io_uring_buffer_group const & group) = delete;
+    io_uring_buffer_group & operator=(io_uring_buffer_group const & group) = delete;
+
+    //! \brief Returns the buffer group id to place in \c io_uring_sqe::buf_group.
+
+    inline uint16_t id() const;
+
+    //! \brief Returns the size of each buffer.
+
+    inline size_t buffer_size() const;
+
+    //! \brief Returns the buffer named by a completion's \c IORING_CQE_F_BUFFER flags.
+
+    inline char * buffer(uint16_t buffer_id) const;
+
+    //! \brief Returns a buffer to the kernel for reuse.
+
+    void recycle(uint16_t buffer_id);
+
+private:
+    io_uring_reactor & reactor_;
+    uint16_t id_;
+    unsigned count_;
+    size_t buffer_size_;
+    std::unique_ptr<char []> buffers_;
+};
+
+#include "meridian/reactor/io_uring_buffer_group.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__io_uring_buffer_group__hpp */
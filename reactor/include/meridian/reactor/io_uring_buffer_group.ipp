@@ -0,0 +1,21 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+uint16_t io_uring_buffer_group::id() const
+{
+    return id_;
+}
+
+
+size_t io_uring_buffer_group::buffer_size() const
+{
+    return buffer_size_;
+}
+
+
+char * io_uring_buffer_group::buffer(uint16_t buffer_id) const
+{
+    assert(buffer_id < count_);
+    return buffers_.get() + buffer_id * buffer_size_;
+}
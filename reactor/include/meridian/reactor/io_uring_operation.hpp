@@ -0,0 +1,41 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__io_uring_operation__hpp
+#define meridian__reactor__io_uring_operation__hpp
+
+#if defined(__linux__)
+
+#include <linux/io_uring.h>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A completion-based operation (e.g., a receive) submitted through an io_uring_reactor.
+//! \class io_uring_operation io_uring_operation.hpp meridian/reactor/io_uring_operation.hpp
+//!
+//! This is the extension point for proactor-style I/O: derive from io_uring_operation, obtain a submission queue entry
+//! for it with io_uring_reactor::prepare(), and fill the entry in. When the kernel posts the operation's completion,
+//! the reactor calls complete() from wait_for_events(). The operation must stay alive until then; an operation which
+//! owns itself may delete itself in complete() (unless \c IORING_CQE_F_MORE is set on a multishot completion).
+//!
+//! \author Eric Crampton
+
+class io_uring_operation {
+public:
+    virtual ~io_uring_operation() { }
+
+    //! \brief Called with the operation's completion.
+    //!
+    //! \param cqe - the completion; \c res holds the result or a negated \c errno value
+
+    virtual void complete(io_uring_cqe const & cqe) = 0;
+};
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__io_uring_operation__hpp */
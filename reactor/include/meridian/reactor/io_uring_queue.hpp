@@ -0,0 +1,103 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__io_uring_queue__hpp
+#define meridian__reactor__io_uring_queue__hpp
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <ctime>
+#include <linux/io_uring.h>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A Linux \c io_uring instance: the submission and completion rings, mapped into user space.
+//! \class io_uring_queue io_uring_queue.hpp meridian/reactor/io_uring_queue.hpp
+//!
+//! This is the plumbing beneath io_uring_reactor, talking to the kernel through the raw \c io_uring_setup (2) and
+//! \c io_uring_enter (2) system calls rather than liburing. Submission queue entries are obtained with get_sqe(),
+//! filled in by the caller, and handed to the kernel in a batch by enter(). Completions are reaped straight from the
+//! shared completion ring by for_each_completion(), which never makes a system call.
+//!
+//! \author Eric Crampton
+
+class io_uring_queue {
+public:
+    //! \brief Creates the ring.
+    //!
+    //! \param entries - submission queue size (the completion queue is twice as large)
+    //!
+    //! Throws unsupported_operation_exception if the kernel lacks a feature the queue relies on (single \c mmap
+    //! rings and extended \c io_uring_enter arguments, both in Linux 5.11 and later).
+
+    explicit io_uring_queue(unsigned entries);
+    ~io_uring_queue();
+
+    io_uring_queue(io_uring_queue const & queue) = delete;
+    io_uring_queue & operator=(io_uring_queue const & queue) = delete;
+
+    //! \brief Returns a zeroed submission queue entry, or \c nullptr if the submission queue is full.
+    //!
+    //! The entry is submitted by the next call to enter().
+
+    io_uring_sqe * get_sqe();
+
+    //! \brief Returns the number of entries obtained from get_sqe() which the kernel hasn't yet consumed.
+
+    inline unsigned pending() const;
+
+    //! \brief Returns true if the completion ring holds unreaped completions.
+
+    inline bool has_completions() const;
+
+    //! \brief Submits all pending entries and optionally waits for completions, in one \c io_uring_enter (2).
+    //!
+    //! \param min_complete - number of completions to wait for (0 to only submit)
+    //! \param timeout - maximum time to wait, or \c nullptr to wait indefinitely
+    //!
+    //! Returns without an error if the wait times out or is interrupted by a signal.
+    //!
+    //! \return false if the kernel refused new work until completions are reaped (\c EBUSY or \c EAGAIN); the entries
+    //! remain pending
+
+    bool enter(unsigned min_complete, timespec const * timeout);
+
+    //! \brief Calls \a f on every completion in the completion ring, then releases them to the kernel.
+    //!
+    //! \return the number of completions processed
+
+    template <typename FUNCTION>
+    unsigned for_each_completion(FUNCTION f);
+
+private:
+    int ring_fd_;
+    unsigned features_;
+
+    void * ring_;
+    size_t ring_size_;
+    io_uring_sqe * sqes_;
+    size_t sqes_size_;
+
+    unsigned * sq_head_;
+    unsigned * sq_tail_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned sq_local_tail_;
+
+    unsigned * cq_head_;
+    unsigned * cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe * cqes_;
+};
+
+#include "meridian/reactor/io_uring_queue.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__io_uring_queue__hpp */
@@ -0,0 +1,32 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+unsigned io_uring_queue::pending() const
+{
+    return sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+}
+
+
+bool io_uring_queue::has_completions() const
+{
+    return __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) != *cq_head_;
+}
+
+
+template <typename FUNCTION>
+unsigned io_uring_queue::for_each_completion(FUNCTION f)
+{
+    unsigned head = *cq_head_;
+    unsigned const tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned const count = tail - head;
+
+    for (; head != tail; ++head) {
+        // Copied so the slot can be released before f runs; f may submit (and complete) more work.
+        io_uring_cqe const cqe = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        f(cqe);
+    }
+
+    return count;
+}
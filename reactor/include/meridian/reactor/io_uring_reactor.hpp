@@ -0,0 +1,221 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__io_uring_reactor__hpp
+#define meridian__reactor__io_uring_reactor__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/event_source_registry.hpp"
+#include "meridian/reactor/io_uring_operation.hpp"
+#include "meridian/reactor/io_uring_queue.hpp"
+#include "meridian/reactor/post_queue.hpp"
+#include "meridian/reactor/scoped_registration.hpp"
+#include "meridian/reactor/timer_wheel.hpp"
+#include "meridian/reactor/trigger_mode.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <poll.h>
+#include <vector>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A reactor built on Linux's \c io_uring poll requests.
+//! \class io_uring_reactor io_uring_reactor.hpp meridian/reactor/io_uring_reactor.hpp
+//!
+//! The registration interface is identical to select_reactor's. Each registered event_source has exactly one armed
+//! poll request covering all of its callbacks.
+//!
+//! For an event_source in trigger_mode::edge (see set_trigger_mode()), that request is a multishot poll: it's armed
+//! once and keeps producing completions, one per wakeup, without ever being re-submitted. Multishot poll can't be
+//! level-triggered, so the default trigger_mode::level instead uses a one-shot poll which is re-armed after each
+//! completion. Arming checks readiness immediately, which gives the same semantics as select_reactor: a callback which
+//! leaves data unread is called again on the next wait_for_events().
+//!
+//! A poll request which fails, e.g., because its descriptor was closed without its registration being removed, is
+//! reported to the read and write callbacks as an error, as epoll_reactor reports \c EPOLLERR. If the descriptor
+//! can't be polled at all (\c EBADF or \c EINVAL), no new request is armed until its registration changes.
+//!
+//! As with epoll_reactor, interest changes only mark the file descriptor dirty. All changes made since the previous
+//! wait_for_events() (including those made by callbacks during its dispatch pass) are written to the submission ring
+//! together and handed to the kernel by the same single \c io_uring_enter (2) which waits for the next completions.
+//! Completions are read directly from the shared completion ring, and no system call is made at all when completions
+//! are already waiting and nothing needs submitting.
+//!
+//! Besides readiness callbacks, an io_uring_reactor also drives completion-based operations (see io_uring_operation
+//! and, e.g., stream_socket::async_receive()). Both kinds may be used on the same event_source, so connections can be
+//! moved from one model to the other gradually.
+//!
+//! \author Eric Crampton
+
+class io_uring_reactor {
+public:
+    explicit io_uring_reactor(unsigned entries = 256);
+    io_uring_reactor(std::unique_ptr<core::abstract_event_source_registry> registry, unsigned entries = 256);
+
+    template <event_type EVENT_TYPE>
+    using scoped_registration = reactor::scoped_registration<io_uring_reactor, EVENT_TYPE>;
+
+    void register_read_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_write_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_except_callback(core::event_source & source, core::event_source::event_callback callback);
+
+    void remove_read_callback(core::event_source & source);
+    void remove_write_callback(core::event_source & source);
+    void remove_except_callback(core::event_source & source);
+
+    //! \brief Registers a unified handler, called once per wakeup with all of \a source's ready events of interest.
+    //!
+    //! \param source - the event_source to monitor
+    //! \param handler - the handler
+    //! \param interest - the events to monitor; may be changed cheaply later with set_interest()
+    //!
+    //! No per-event callbacks may be registered on \a source at the same time.
+
+    void register_handler(
+            core::event_source & source,
+            core::event_source::event_handler handler,
+            core::event_source::event_mask interest);
+
+    //! \brief Changes the events monitored for an event_source with a unified handler.
+
+    void set_interest(core::event_source & source, core::event_source::event_mask interest);
+
+    //! \brief Removes the unified handler for an event_source.
+
+    void remove_handler(core::event_source & source);
+
+    //! \brief Identifies a timer scheduled with schedule_after() or schedule_at().
+    typedef timer_wheel::timer_id timer_id;
+
+    //! \brief The clock timer deadlines are measured against.
+    typedef timer_wheel::clock clock;
+
+    //! \brief Schedules \a callback to be called by wait_for_events() once \a delay has elapsed.
+    //!
+    //! Timers are kept in a timer_wheel: scheduling and cancellation are O(1), each wait is bounded by the nearest
+    //! deadline, and all expired timers are called together after that wait's I/O callbacks.
+
+    timer_id schedule_after(clock::duration delay, timer_wheel::timer_callback callback);
+
+    //! \brief Schedules \a callback to be called by wait_for_events() once \a deadline has passed.
+
+    timer_id schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback);
+
+    //! \brief Cancels a timer; returns false if it has already expired or been cancelled.
+
+    bool cancel(timer_id timer);
+
+    //! \brief Queues \a callback to be called by wait_for_events(). May be called from any thread.
+    //!
+    //! This is the only member function which may be called from a thread other than the one running
+    //! wait_for_events(). Callbacks are queued without a lock, and a wait is only interrupted when the queue was empty,
+    //! so posting is cheap even at high rates. See post_queue.
+
+    void post(post_queue::posted_callback callback);
+
+    //! \brief Selects level- or edge-triggered notification for an event_source.
+    //!
+    //! \param source - the event_source
+    //! \param mode - the trigger mode
+    //!
+    //! The mode applies to all of the event_source's callbacks and is reset to trigger_mode::level once its last
+    //! callback is removed. It may be set before or after registering callbacks.
+
+    void set_trigger_mode(core::event_source & source, trigger_mode mode);
+
+    //! \brief Requests a fresh notification for an edge-triggered event_source which is still ready.
+    //!
+    //! \param source - an event_source with at least one registered callback
+    //!
+    //! The multishot request is replaced on the next wait_for_events(); the new request completes at once if the
+    //! event_source is still ready.
+
+    void rearm(core::event_source & source);
+
+    //! \brief Returns a zeroed submission queue entry whose completion will be passed to \a operation.
+    //!
+    //! \param operation - the operation to complete; it must remain valid until its (final) completion
+    //!
+    //! The caller fills in the entry's opcode and arguments but must not change its \c user_data. The entry is
+    //! submitted together with any interest changes by the next wait_for_events().
+
+    io_uring_sqe * prepare(io_uring_operation & operation);
+
+    void wait_for_events();
+
+private:
+    friend class io_uring_buffer_group;
+
+    //! \brief Records that the poll request for \a fd may not match the registered callbacks.
+
+    inline void mark_dirty(int fd);
+
+    //! \brief Like mark_dirty(int), but also resets per-fd options once \a source has no callbacks left, and forces
+    //! any later registration on the descriptor to be re-submitted.
+
+    inline void mark_dirty_after_remove(core::event_source & source);
+
+    //! \brief Returns the \c poll (2) events corresponding to the interest set of \a source.
+
+    inline static uint32_t interest_mask(core::event_source const & source);
+
+    //! \brief Returns the events a unified handler is told about for the given ready \a events.
+
+    inline static core::event_source::event_mask ready_mask(uint32_t events);
+
+    //! \brief Returns the \c user_data identifying the poll request for \a fd with the given generation.
+    //!
+    //! Poll requests are distinguished from io_uring_operation pointers (which are at least 2-byte aligned) by having
+    //! the low bit set.
+
+    inline static uint64_t poll_user_data(int fd, uint32_t generation);
+
+    //! \brief Writes the poll requests needed to bring every dirty fd up to date into the submission ring.
+
+    void flush_interest_changes();
+
+    //! \brief Returns a submission queue entry, submitting what's pending first if the ring is full.
+    //!
+    //! If the kernel won't accept more work until completions are reaped, they're moved to deferred_completions_.
+
+    io_uring_sqe * get_sqe();
+
+    //! \brief Invokes the callbacks for one poll completion.
+
+    void dispatch(io_uring_cqe const & cqe);
+
+private:
+    //! \brief \c user_data for requests whose completions are ignored (e.g., poll removal).
+    static uint64_t const IGNORED_USER_DATA = ~uint64_t(0);
+
+    //! \brief Per-fd bookkeeping, indexed by file descriptor.
+    struct fd_state {
+        uint32_t armed_events; //!< events of the armed poll request, or 0 if none is armed
+        uint32_t generation;   //!< identifies the armed request; completions from earlier requests are stale
+        bool dirty;            //!< true if \a fd is on the dirty list
+        bool armed_multishot;  //!< true if the armed request is a multishot poll
+        bool edge_triggered;   //!< true if trigger_mode::edge was requested
+        bool rearm;            //!< true if the armed request must be replaced even if unchanged
+    };
+
+    post_queue posted_;               //!< declared first, to outlive registry_, in which its source is registered
+    std::unique_ptr<core::abstract_event_source_registry> registry_;
+    io_uring_queue queue_;
+    std::vector<fd_state> fd_states_;
+    std::vector<int> dirty_fds_;
+    std::vector<io_uring_cqe> deferred_completions_; //!< reaped by get_sqe(), awaiting dispatch
+    timer_wheel timers_;
+};
+
+#include "meridian/reactor/io_uring_reactor.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__io_uring_reactor__hpp */
@@ -0,0 +1,54 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+void io_uring_reactor::mark_dirty(int fd)
+{
+    assert(fd >= 0);
+
+    if (static_cast<size_t>(fd) >= fd_states_.size()) {
+        fd_states_.resize(std::max(static_cast<size_t>(fd) + 1, fd_states_.size() * 2), fd_state{ 0, 0, false, false, false, false });
+    }
+
+    if (!fd_states_[fd].dirty) {
+        fd_states_[fd].dirty = true;
+        dirty_fds_.push_back(fd);
+    }
+}
+
+
+void io_uring_reactor::mark_dirty_after_remove(core::event_source & source)
+{
+    mark_dirty(source.fd());
+
+    if (!source.has_callback()) {
+        // The descriptor may now be closed and reused before the next flush, while the armed request still holds
+        // the old file; a new registration with the same interest must replace it rather than being skipped.
+        fd_states_[source.fd()].edge_triggered = false;
+        fd_states_[source.fd()].rearm = true;
+    }
+}
+
+
+uint32_t io_uring_reactor::interest_mask(core::event_source const & source)
+{
+    core::event_source::event_mask const interest = source.interest();
+
+    return (interest & core::event_source::READABLE  ? POLLIN  : 0)
+         | (interest & core::event_source::WRITABLE  ? POLLOUT : 0)
+         | (interest & core::event_source::EXCEPTION ? POLLPRI : 0);
+}
+
+
+core::event_source::event_mask io_uring_reactor::ready_mask(uint32_t events)
+{
+    return (events & (POLLIN | POLLHUP | POLLERR) ? core::event_source::READABLE  : 0)
+         | (events & (POLLOUT | POLLERR)          ? core::event_source::WRITABLE  : 0)
+         | (events & POLLPRI                      ? core::event_source::EXCEPTION : 0);
+}
+
+
+uint64_t io_uring_reactor::poll_user_data(int fd, uint32_t generation)
+{
+    return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(fd) << 1) | 1;
+}
@@ -0,0 +1,108 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__poll_reactor__hpp
+#define meridian__reactor__poll_reactor__hpp
+
+#include "meridian/core/event_source_registry.hpp"
+#include "meridian/reactor/post_queue.hpp"
+#include "meridian/reactor/scoped_registration.hpp"
+#include "meridian/reactor/timer_wheel.hpp"
+
+#include <memory>
+#include <poll.h>
+#include <utility>
+#include <vector>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A portable reactor built on \c poll (2).
+//! \class poll_reactor poll_reactor.hpp meridian/reactor/poll_reactor.hpp
+//!
+//! The registration interface is identical to select_reactor's, but there's no \c FD_SETSIZE ceiling: any file
+//! descriptor may be registered. This is the fallback for systems without a more scalable mechanism (see
+//! epoll_reactor).
+//!
+//! The \c pollfd array handed to the kernel is kept densely packed, holding exactly one entry per registered file
+//! descriptor, and a second array maps each file descriptor to its entry. Removing a file descriptor's last callback
+//! moves the final entry into its place, so registration and removal are both O(1).
+//!
+//! \author Eric Crampton
+
+class poll_reactor {
+public:
+    poll_reactor();
+    poll_reactor(std::unique_ptr<core::abstract_event_source_registry> registry);
+
+    poll_reactor(poll_reactor const & reactor) = delete;
+    poll_reactor & operator=(poll_reactor const & reactor) = delete;
+
+    template <event_type EVENT_TYPE>
+    using scoped_registration = reactor::scoped_registration<poll_reactor, EVENT_TYPE>;
+
+    void register_read_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_write_callback(core::event_source & source, core::event_source::event_callback callback);
+    void register_except_callback(core::event_source & source, core::event_source::event_callback callback);
+
+    void remove_read_callback(core::event_source & source);
+    void remove_write_callback(core::event_source & source);
+    void remove_except_callback(core::event_source & source);
+
+    void register_handler(
+            core::event_source & source,
+            core::event_source::event_handler handler,
+            core::event_source::event_mask interest);
+    void set_interest(core::event_source & source, core::event_source::event_mask interest);
+    void remove_handler(core::event_source & source);
+
+    typedef timer_wheel::timer_id timer_id;
+    typedef timer_wheel::clock clock;
+
+    timer_id schedule_after(clock::duration delay, timer_wheel::timer_callback callback);
+    timer_id schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback);
+    bool cancel(timer_id timer);
+
+    void post(post_queue::posted_callback callback);
+
+    void wait_for_events();
+
+private:
+    //! \brief Adds \a events to the \c pollfd entry for \a fd, creating the entry if needed.
+
+    inline void add_events(int fd, short events);
+
+    //! \brief Removes \a events from the \c pollfd entry for \a fd, removing the entry once no events remain.
+
+    inline void remove_events(int fd, short events);
+
+    //! \brief Replaces the events in the \c pollfd entry for \a fd, removing the entry if \a events is empty.
+
+    inline void set_events(int fd, short events);
+
+    //! \brief Returns the \c poll (2) events corresponding to an interest set.
+
+    inline static short poll_events(core::event_source::event_mask interest);
+
+    //! \brief Returns the events a unified handler is told about for the given \c revents.
+
+    inline static core::event_source::event_mask ready_mask(short revents);
+
+private:
+    static int const NO_SLOT = -1;
+
+    post_queue posted_;               //!< declared first, to outlive registry_, in which its source is registered
+    std::unique_ptr<core::abstract_event_source_registry> registry_;
+    std::vector<pollfd> pollfds_;
+    std::vector<int> slots_;                  //!< index into pollfds_ by file descriptor, or NO_SLOT
+    std::vector<std::pair<int, short>> ready_; //!< scratch space for the (fd, revents) of one wait
+    timer_wheel timers_;
+};
+
+#include "meridian/reactor/poll_reactor.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__poll_reactor__hpp */
@@ -0,0 +1,63 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+void poll_reactor::add_events(int fd, short events)
+{
+    assert(fd >= 0);
+
+    if (static_cast<size_t>(fd) >= slots_.size()) {
+        slots_.resize(std::max(static_cast<size_t>(fd) + 1, slots_.size() * 2), NO_SLOT);
+    }
+
+    if (slots_[fd] == NO_SLOT) {
+        slots_[fd] = pollfds_.size();
+        pollfds_.push_back(pollfd{ fd, 0, 0 });
+    }
+
+    pollfds_[slots_[fd]].events |= events;
+}
+
+
+void poll_reactor::remove_events(int fd, short events)
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || slots_[fd] == NO_SLOT) {
+        return;
+    }
+
+    int const slot = slots_[fd];
+    pollfds_[slot].events &= ~events;
+
+    if (!pollfds_[slot].events) {
+        pollfds_[slot] = pollfds_.back();
+        slots_[pollfds_[slot].fd] = slot;
+        pollfds_.pop_back();
+        slots_[fd] = NO_SLOT;
+    }
+}
+
+
+void poll_reactor::set_events(int fd, short events)
+{
+    remove_events(fd, ~events & (POLLIN | POLLOUT | POLLPRI));
+
+    if (events) {
+        add_events(fd, events);
+    }
+}
+
+
+short poll_reactor::poll_events(core::event_source::event_mask interest)
+{
+    return (interest & core::event_source::READABLE  ? POLLIN  : 0)
+         | (interest & core::event_source::WRITABLE  ? POLLOUT : 0)
+         | (interest & core::event_source::EXCEPTION ? POLLPRI : 0);
+}
+
+
+core::event_source::event_mask poll_reactor::ready_mask(short revents)
+{
+    return (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL) ? core::event_source::READABLE  : 0)
+         | (revents & (POLLOUT | POLLERR | POLLNVAL)          ? core::event_source::WRITABLE  : 0)
+         | (revents & POLLPRI                                 ? core::event_source::EXCEPTION : 0);
+}
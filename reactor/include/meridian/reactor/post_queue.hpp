@@ -0,0 +1,97 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__post_queue__hpp
+#define meridian__reactor__post_queue__hpp
+
+#include "meridian/core/delegate.hpp"
+#include "meridian/reactor/wakeup_source.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A queue of callbacks which any thread may post to a reactor, to be run by the reactor's own thread.
+//! \class post_queue post_queue.hpp meridian/reactor/post_queue.hpp
+//!
+//! Posted callbacks are pushed onto an intrusive lock-free stack: post() moves the callback into a node and links it
+//! in with a single compare-and-swap, taking no lock. Only the post() which finds the stack empty notifies the
+//! wakeup_source, so a burst of posts made while the reactor is busy costs one wakeup, not one per callback.
+//!
+//! The reactor registers source() for reading and calls run() when it's readable. run() detaches the whole stack with
+//! a single exchange, reverses it so that callbacks run in the order they were posted (by any one thread), and runs
+//! the batch. Callbacks posted while the batch runs, including by the batch itself, are left for the next run().
+//!
+//! Nodes aren't freed once run, but recycled: each posting thread takes them from its own free list, and run() hands
+//! the batch's nodes back to the threads which posted them, with one compare-and-swap per run of nodes from the same
+//! thread. In the steady state, then, posting doesn't allocate, and no memory crosses threads through the allocator.
+//! A posting thread allocates only while it has more callbacks in flight than ever before, and a callable too large
+//! to be stored inline in a delegate still allocates when it's posted, as it would anywhere else.
+//!
+//! A post_queue isn't used directly; each reactor has one, exposed through its post() function.
+//!
+//! \author Eric Crampton
+
+class post_queue {
+public:
+    //! \brief Posted callback function type.
+    typedef core::delegate<void ()> posted_callback;
+
+    post_queue();
+
+    //! \brief Destruction; callbacks which haven't been run are destroyed without being called.
+
+    ~post_queue();
+
+    post_queue(post_queue const & queue) = delete;
+    post_queue & operator=(post_queue const & queue) = delete;
+
+    //! \brief Queues \a callback to be run by the owning thread. May be called from any thread.
+
+    void post(posted_callback callback);
+
+    //! \brief Runs every callback posted before the call. Must only be called from the owning thread.
+    //!
+    //! \return the number of callbacks run
+    //!
+    //! If a callback throws, the rest of its batch stays queued and is run, ahead of anything posted since, by the
+    //! next run().
+
+    size_t run();
+
+    //! \brief Returns the event_source which becomes readable when callbacks are posted to an empty queue.
+
+    inline core::event_source & source();
+
+private:
+    class node_cache;
+
+    struct node {
+        node * next;
+        node_cache * home;             //!< the free list of the thread which allocated the node
+        posted_callback callback;
+    };
+
+    //! \brief Destroys the callbacks of \a first and every node linked from it, and recycles the nodes.
+
+    static void destroy(node * first) noexcept;
+
+    //! \brief Hands \a first and every node linked from it, whose callbacks have been destroyed, back to their homes.
+
+    static void recycle(node * first) noexcept;
+
+private:
+    std::atomic<node *> posted_;       //!< posted callbacks, most recent first
+    node * batch_;                     //!< callbacks being run by run(), oldest first
+    wakeup_source wakeup_;
+};
+
+#include "meridian/reactor/post_queue.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__post_queue__hpp */
@@ -2,7 +2,7 @@
 // Distributed under the Boost Software License, Version 1.0.
 // (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-int socket::fd()
+core::event_source & post_queue::source()
 {
-    return fd_;
+    return wakeup_;
 }
@@ -12,15 +12,15 @@ scoped_registration<REACTOR_TYPE, EVENT_TYPE>::scoped_registration(
 {
     switch (EVENT_TYPE) {
         case event_type::read:
-            reactor_.register_read_callback(*source_, callback);
+            reactor_.register_read_callback(*source_, std::move(callback));
             break;
 
         case event_type::write:
-            reactor_.register_write_callback(*source_, callback);
+            reactor_.register_write_callback(*source_, std::move(callback));
             break;
 
         case event_type::except:
-            reactor_.register_except_callback(*source_, callback);
+            reactor_.register_except_callback(*source_, std::move(callback));
             break;
     }
 }
@@ -28,14 +28,6 @@ scoped_registration<REACTOR_TYPE, EVENT_TYPE>::scoped_registration(
 
 template <typename REACTOR_TYPE, event_type EVENT_TYPE>
 void scoped_registration<REACTOR_TYPE, EVENT_TYPE>::remove()
-{
-    reactor_.remove_read_callback(source_);
-    source_ = nullptr;
-}
-
-
-template <typename REACTOR_TYPE, event_type EVENT_TYPE>
-scoped_registration<REACTOR_TYPE, EVENT_TYPE>::~scoped_registration()
 {
     if (!source_) {
         return;
@@ -54,4 +46,13 @@ scoped_registration<REACTOR_TYPE, EVENT_TYPE>::~scoped_registration()
             reactor_.remove_except_callback(*source_);
             break;
     }
+
+    source_ = nullptr;
+}
+
+
+template <typename REACTOR_TYPE, event_type EVENT_TYPE>
+scoped_registration<REACTOR_TYPE, EVENT_TYPE>::~scoped_registration()
+{
+    remove();
 }
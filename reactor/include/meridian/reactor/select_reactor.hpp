@@ -6,9 +6,12 @@
 #define meridian__reactor__select_reactor__hpp
 
 #include "meridian/core/event_source_registry.hpp"
+#include "meridian/reactor/post_queue.hpp"
 #include "meridian/reactor/scoped_registration.hpp"
+#include "meridian/reactor/timer_wheel.hpp"
 
-#include <boost/optional.hpp>
+#include <climits>
+#include <cstdint>
 #include <memory>
 #include <sys/select.h>
 
@@ -18,7 +21,10 @@ namespace reactor {
 class select_reactor {
 public:
     select_reactor();
-    select_reactor(std::unique_ptr<core::event_source_registry> registry);
+    select_reactor(std::unique_ptr<core::abstract_event_source_registry> registry);
+
+    select_reactor(select_reactor const & reactor) = delete;
+    select_reactor & operator=(select_reactor const & reactor) = delete;
 
     template <event_type EVENT_TYPE>
     using scoped_registration = reactor::scoped_registration<select_reactor, EVENT_TYPE>;
@@ -31,30 +37,85 @@ public:
     void remove_write_callback(core::event_source & source);
     void remove_except_callback(core::event_source & source);
 
+    void register_handler(
+            core::event_source & source,
+            core::event_source::event_handler handler,
+            core::event_source::event_mask interest);
+    void set_interest(core::event_source & source, core::event_source::event_mask interest);
+    void remove_handler(core::event_source & source);
+
+    typedef timer_wheel::timer_id timer_id;
+    typedef timer_wheel::clock clock;
+
+    timer_id schedule_after(clock::duration delay, timer_wheel::timer_callback callback);
+    timer_id schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback);
+    bool cancel(timer_id timer);
+
+    void post(post_queue::posted_callback callback);
+
     void wait_for_events();
     
 private:
-    inline void cache_fd_read_register(core::event_source & source) {
-        if (!maxfd_ || source.fd() > *maxfd_) {
-            maxfd_ = source.fd();
+    //! \brief Throws if \a source's fd can't be placed in an \c fd_set, which would otherwise corrupt memory.
+
+    static void check_fd_setsize(core::event_source const & source);
+
+    //! \brief Sets or clears \a fd in each of the three sets according to \a interest.
+
+    void update_sets(int fd, core::event_source::event_mask interest);
+
+    //! \brief The machine word an \c fd_set is made of; bit \c fd % BITS_PER_WORD of word \c fd / BITS_PER_WORD.
+    typedef unsigned long fd_word;
+
+    static size_t const BITS_PER_WORD = sizeof(fd_word) * CHAR_BIT;
+    static size_t const WORDS_PER_SET = sizeof(fd_set) / sizeof(fd_word);
+
+    static_assert(sizeof(fd_set) % sizeof(fd_word) == 0, "fd_set must be an array of machine words");
+    static_assert(WORDS_PER_SET <= 64, "the summary mask needs a bit per fd_set word");
+
+    inline static fd_word const * words(fd_set const & set) {
+        return reinterpret_cast<fd_word const *>(&set);
+    }
+
+    //! \brief Updates the summary bit for the word holding \a fd after it's been set or cleared in any of the sets.
+
+    inline void update_summary(int fd) {
+        size_t const word = fd / BITS_PER_WORD;
+        uint64_t const bit = uint64_t(1) << word;
+
+        if (words(read_set_)[word] | words(write_set_)[word] | words(except_set_)[word]) {
+            summary_ |= bit;
+        }
+        else {
+            summary_ &= ~bit;
         }
     }
-    
-    inline void recache_max_fd() {
-        maxfd_ = -1;
-        
-        for (auto bucket : *registry_) {
-            maxfd_ = std::max(bucket.fd(), *maxfd_);
+
+    //! \brief Returns the largest registered fd, or -1 if none is registered, in constant time.
+
+    inline int max_fd() const {
+        if (!summary_) {
+            return -1;
         }
+
+        size_t const word = 63 - __builtin_clzll(summary_);
+        fd_word const bits = words(read_set_)[word] | words(write_set_)[word] | words(except_set_)[word];
+
+        return word * BITS_PER_WORD + (BITS_PER_WORD - 1 - __builtin_clzl(bits));
     }
     
 private:
-    std::unique_ptr<core::event_source_registry> registry_;
-    boost::optional<int> maxfd_;
+    post_queue posted_;               //!< declared first, to outlive registry_, in which its source is registered
+    std::unique_ptr<core::abstract_event_source_registry> registry_;
+
+    //! \brief Bit \c w is set if word \c w of any of the three sets is non-zero.
+    uint64_t summary_;
 
     fd_set read_set_;
     fd_set write_set_;
     fd_set except_set_;
+
+    timer_wheel timers_;
 };
 
 } // namespace reactor
@@ -0,0 +1,69 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__signal_source__hpp
+#define meridian__reactor__signal_source__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/event_source.hpp"
+
+#include <initializer_list>
+#include <signal.h>
+#include <sys/signalfd.h>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief An event_source which becomes readable when signals arrive, built on Linux's \c signalfd (2).
+//! \class signal_source signal_source.hpp meridian/reactor/signal_source.hpp
+//!
+//! Signals are delivered to the event loop as ordinary readable events rather than by interrupting whatever happens
+//! to be running, so the callback may do anything, not just async-signal-safe things.
+//!
+//! A signal is only queued for the signal_source if it's blocked, so construction blocks the given signals in the
+//! calling thread. Every other thread must block them as well, or the kernel may deliver them there instead; the
+//! simplest way is to create the signal_source before starting any threads, which inherit the blocked set. The signals
+//! are left blocked on destruction: the thread's previous signal mask isn't restored, so a caller which needs it back
+//! must save it first. The descriptor is non-blocking and close-on-exec, and is closed on destruction.
+//!
+//! \author Eric Crampton
+
+class signal_source : public core::event_source {
+public:
+    //! \brief Construction.
+    //!
+    //! \param signals - the signals to receive; these are blocked in the calling thread
+
+    explicit signal_source(sigset_t const & signals);
+
+    //! \brief Construction from a list of signal numbers (e.g., <tt>{ SIGINT, SIGTERM }</tt>).
+
+    explicit signal_source(std::initializer_list<int> signals);
+
+    //! \brief Destruction; closes the descriptor.
+
+    ~signal_source();
+
+    signal_source(signal_source const & source) = delete;
+    signal_source & operator=(signal_source const & source) = delete;
+
+    //! \brief Dequeues one pending signal.
+    //!
+    //! \param info - receives the signal number (\c ssi_signo), sender, and so on
+    //!
+    //! \return true if a signal was dequeued; false if none is pending
+
+    bool read_signal(signalfd_siginfo & info);
+
+private:
+    void init(sigset_t const & signals);
+};
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__signal_source__hpp */
@@ -0,0 +1,91 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__spsc_channel__hpp
+#define meridian__reactor__spsc_channel__hpp
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A bounded, lock-free queue between exactly one producer thread and one consumer thread.
+//! \class spsc_channel spsc_channel.hpp meridian/reactor/spsc_channel.hpp
+//!
+//! Values live in a ring whose capacity is a power of two. The producer only writes the tail index and the consumer
+//! only writes the head index, each with a single release store, so neither side ever waits on the other. Each side
+//! also keeps a private copy of the other's index and only re-reads the shared one when its copy says the ring is full
+//! (or empty); while the ring is neither, the two threads don't touch each other's cache lines at all.
+//!
+//! A channel doesn't wake its consumer; see sharded_runtime for a pairing with a reactor.
+//!
+//! \author Eric Crampton
+
+template <typename T>
+class spsc_channel {
+public:
+    //! \brief Construction.
+    //!
+    //! \param capacity - the number of values the channel can hold, rounded up to a power of two
+
+    explicit spsc_channel(size_t capacity);
+
+    //! \brief Destruction; values which haven't been popped are destroyed.
+
+    ~spsc_channel();
+
+    spsc_channel(spsc_channel const & channel) = delete;
+    spsc_channel & operator=(spsc_channel const & channel) = delete;
+
+    //! \brief Appends \a value, unless the channel is full. Producer only.
+    //!
+    //! \return true if \a value was moved into the channel; false if the channel is full, in which case \a value is
+    //! left untouched
+
+    bool try_push(T && value);
+
+    //! \brief Removes the oldest value into \a value, unless the channel is empty. Consumer only.
+    //!
+    //! \return true if a value was popped
+
+    bool try_pop(T & value);
+
+    //! \brief Returns the number of values the channel can hold.
+
+    inline size_t capacity() const;
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot;
+
+    //! \brief Size of the gap kept between the producer's and the consumer's fields, so they never share a cache line.
+    static size_t const CACHE_LINE = 64;
+
+    inline static size_t round_up_to_power_of_two(size_t value);
+
+    inline T * at(size_t index);
+
+private:
+    size_t const mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    char producer_padding_[CACHE_LINE];
+    std::atomic<size_t> tail_;         //!< index of the next slot to push into; written by the producer
+    size_t cached_head_;               //!< the producer's copy of head_
+
+    char consumer_padding_[CACHE_LINE];
+    std::atomic<size_t> head_;         //!< index of the next slot to pop from; written by the consumer
+    size_t cached_tail_;               //!< the consumer's copy of tail_
+
+    char padding_[CACHE_LINE];
+};
+
+#include "meridian/reactor/spsc_channel.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__spsc_channel__hpp */
@@ -0,0 +1,89 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+template <typename T>
+spsc_channel<T>::spsc_channel(size_t capacity)
+    : mask_(round_up_to_power_of_two(capacity) - 1)
+    , slots_(new slot[mask_ + 1])
+    , tail_(0)
+    , cached_head_(0)
+    , head_(0)
+    , cached_tail_(0)
+{
+}
+
+
+template <typename T>
+spsc_channel<T>::~spsc_channel()
+{
+    size_t const tail = tail_.load(std::memory_order_acquire);
+    for (size_t index = head_.load(std::memory_order_relaxed); index != tail; ++index) {
+        at(index)->~T();
+    }
+}
+
+
+template <typename T>
+bool spsc_channel<T>::try_push(T && value)
+{
+    size_t const tail = tail_.load(std::memory_order_relaxed);
+
+    if (tail - cached_head_ > mask_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ > mask_) {
+            return false;
+        }
+    }
+
+    new (at(tail)) T(std::move(value));
+    tail_.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+bool spsc_channel<T>::try_pop(T & value)
+{
+    size_t const head = head_.load(std::memory_order_relaxed);
+
+    if (head == cached_tail_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head == cached_tail_) {
+            return false;
+        }
+    }
+
+    T * const stored = at(head);
+    value = std::move(*stored);
+    stored->~T();
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <typename T>
+size_t spsc_channel<T>::capacity() const
+{
+    return mask_ + 1;
+}
+
+
+template <typename T>
+size_t spsc_channel<T>::round_up_to_power_of_two(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+
+template <typename T>
+T * spsc_channel<T>::at(size_t index)
+{
+    return reinterpret_cast<T *>(&slots_[index & mask_]);
+}
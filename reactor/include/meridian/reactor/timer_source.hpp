@@ -0,0 +1,75 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__timer_source__hpp
+#define meridian__reactor__timer_source__hpp
+
+#if defined(__linux__)
+
+#include "meridian/core/event_source.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief An event_source which becomes readable when a timer expires, built on Linux's \c timerfd_create (2).
+//! \class timer_source timer_source.hpp meridian/reactor/timer_source.hpp
+//!
+//! The timer is measured against \c CLOCK_MONOTONIC, the clock behind \c std::chrono::steady_clock. It may be armed
+//! relative to now (set_after()) or for an absolute deadline (set_at()), either once or, with a non-zero interval,
+//! periodically. Register a readable callback with any reactor (e.g., with scoped_registration) and call
+//! read_expirations() from it.
+//!
+//! Unlike a reactor's own timers, a timer_source is a file descriptor, so it can be handed to code which only knows
+//! about file descriptors, or shared with another process. The descriptor is non-blocking and close-on-exec, and is
+//! closed on destruction.
+//!
+//! \author Eric Crampton
+
+class timer_source : public core::event_source {
+public:
+    //! \brief The clock the timer is measured against.
+    typedef std::chrono::steady_clock clock;
+
+    //! \brief Construction of a disarmed timer.
+
+    timer_source();
+
+    //! \brief Destruction; closes the timer.
+
+    ~timer_source();
+
+    timer_source(timer_source const & source) = delete;
+    timer_source & operator=(timer_source const & source) = delete;
+
+    //! \brief Arms the timer to expire after \a delay, then every \a interval if it's non-zero.
+    //!
+    //! A \a delay of zero (or less) expires as soon as possible; it doesn't disarm the timer.
+
+    void set_after(clock::duration delay, clock::duration interval = clock::duration::zero());
+
+    //! \brief Arms the timer to expire at \a deadline, then every \a interval if it's non-zero.
+
+    void set_at(clock::time_point deadline, clock::duration interval = clock::duration::zero());
+
+    //! \brief Disarms the timer.
+
+    void disarm();
+
+    //! \brief Returns the number of expirations since the last call, or 0 if the timer hasn't expired since.
+
+    uint64_t read_expirations();
+
+private:
+    void set(int flags, clock::duration value, clock::duration interval);
+};
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
+
+#endif /* meridian__reactor__timer_source__hpp */
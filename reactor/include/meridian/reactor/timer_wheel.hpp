@@ -0,0 +1,171 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__timer_wheel__hpp
+#define meridian__reactor__timer_wheel__hpp
+
+#include "meridian/core/delegate.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief A hierarchical timing wheel holding the timers of a reactor.
+//! \class timer_wheel timer_wheel.hpp meridian/reactor/timer_wheel.hpp
+//!
+//! Time is measured in millisecond ticks since the wheel was created. The wheel has LEVELS levels of SLOTS slots each,
+//! enough to cover every 64-bit tick. A timer is kept on the level given by the most significant 6-bit group in which
+//! its expiry differs from the current tick, in the slot given by that group of its expiry. Advancing the wheel only
+//! visits those slots which the current tick has passed: their timers have either expired or move to a lower level.
+//! Each timer is therefore touched at most once per level, regardless of how many ticks pass.
+//!
+//! Timers are nodes in per-slot doubly linked lists, allocated from a pool which is reused, so scheduling and
+//! cancellation are O(1) and allocate nothing once the pool has grown to the peak number of live timers. A bitmap of
+//! occupied slots per level finds the next deadline in O(LEVELS).
+//!
+//! A timer_wheel isn't used directly; each reactor has one, exposed through its schedule_after(), schedule_at(), and
+//! cancel() functions. The reactor bounds its wait by timeout() and calls expire() once I/O callbacks have run, so all
+//! timers due by then are processed in one batch.
+//!
+//! \author Eric Crampton
+
+class timer_wheel {
+public:
+    //! \brief The clock timers are measured against.
+    typedef std::chrono::steady_clock clock;
+
+    //! \brief Identifies a scheduled timer; never zero, and never reused while the timer is live.
+    typedef uint64_t timer_id;
+
+    //! \brief Timer callback function type.
+    typedef core::delegate<void ()> timer_callback;
+
+    //! \brief Construction.
+    //!
+    //! \param start - the time at which tick 0 begins
+
+    explicit timer_wheel(clock::time_point start = clock::now());
+
+    timer_wheel(timer_wheel const & wheel) = delete;
+    timer_wheel & operator=(timer_wheel const & wheel) = delete;
+
+    //! \brief Schedules \a callback to be called once \a deadline has passed.
+    //!
+    //! \return an identifier which may be passed to cancel()
+    //!
+    //! The callback is called no earlier than \a deadline, by the first expire() at or after it. A deadline which has
+    //! already passed is expired by the next expire().
+
+    timer_id schedule_at(clock::time_point deadline, timer_callback callback);
+
+    //! \brief Schedules \a callback to be called once \a delay has elapsed from now.
+
+    inline timer_id schedule_after(clock::duration delay, timer_callback callback);
+
+    //! \brief Cancels a timer.
+    //!
+    //! \return true if the timer was pending and is now cancelled; false if it has already expired or been cancelled
+
+    bool cancel(timer_id timer);
+
+    //! \brief Returns the number of pending timers.
+
+    inline size_t size() const;
+
+    //! \brief Returns how long a reactor may wait, in milliseconds, before expire() has work to do.
+    //!
+    //! \param now - the current time
+    //! \param maximum - the value to return if no timer is pending, or if the next one is further away
+
+    int timeout(clock::time_point now, int maximum) const;
+
+    //! \brief Advances the wheel to \a now and calls the callbacks of all timers which have expired.
+    //!
+    //! \return the number of callbacks called
+    //!
+    //! Callbacks may schedule and cancel timers. A timer scheduled by a callback is never called by the same expire().
+
+    size_t expire(clock::time_point now = clock::now());
+
+private:
+    static unsigned const SLOT_BITS = 6;
+    static unsigned const SLOTS = 1 << SLOT_BITS;
+    static unsigned const LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+    static uint32_t const NIL = ~uint32_t(0);
+
+    //! \brief The lists a node can be on other than a slot: none (it's free), expired, or being called by expire().
+    static uint16_t const NO_LIST = 0xffff;
+    static uint16_t const EXPIRED_LIST = 0xfffe;
+    static uint16_t const RUNNING_LIST = 0xfffd;
+
+    //! \brief A doubly linked list of nodes, by index.
+    struct list {
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    //! \brief A timer.
+    struct node {
+        uint64_t expiry;         //!< the tick at which the timer expires
+        uint32_t prev;
+        uint32_t next;           //!< next node in the list; also links the free list
+        uint32_t generation;     //!< incremented each time the node is freed, to detect stale timer_ids
+        uint16_t list;           //!< level * SLOTS + slot, or one of NO_LIST, EXPIRED_LIST, and RUNNING_LIST
+        timer_callback callback;
+    };
+
+    //! \brief Returns the tick containing \a time, rounding up if \a round_up and \a time falls between ticks.
+
+    inline uint64_t to_tick(clock::time_point time, bool round_up) const;
+
+    //! \brief Returns \a tick shifted right to leave the groups at and above \a level.
+
+    inline static uint64_t prefix(uint64_t tick, unsigned level);
+
+    //! \brief Places node \a index on the level and slot for its expiry, or on the expired list if it's due.
+
+    void insert(uint32_t index);
+
+    //! \brief Appends node \a index to \a target, which is list number \a list_id.
+
+    inline void push_back(list & target, uint16_t list_id, uint32_t index);
+
+    //! \brief Removes node \a index from whichever list it's on.
+
+    inline void unlink(uint32_t index);
+
+    //! \brief Returns the list with the given number.
+
+    inline list & list_for(uint16_t list_id);
+
+    //! \brief Returns node \a index to the pool.
+
+    inline void free_node(uint32_t index);
+
+    //! \brief Moves every timer in a slot the tick has passed to the expired list or a lower level.
+
+    void advance(uint64_t tick);
+
+private:
+    clock::time_point start_;
+    uint64_t now_;
+    size_t size_;
+    std::vector<node> nodes_;
+    uint32_t free_;
+    list expired_;                     //!< timers which are due, in the order they became due
+    list running_;                     //!< timers being called by expire()
+    uint64_t occupied_[LEVELS];        //!< bit \c s of word \c l is set if slot \c s of level \c l is non-empty
+    list slots_[LEVELS][SLOTS];
+};
+
+#include "meridian/reactor/timer_wheel.ipp"
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__timer_wheel__hpp */
@@ -0,0 +1,110 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+timer_wheel::timer_id timer_wheel::schedule_after(clock::duration delay, timer_callback callback)
+{
+    return schedule_at(clock::now() + delay, std::move(callback));
+}
+
+
+size_t timer_wheel::size() const
+{
+    return size_;
+}
+
+
+uint64_t timer_wheel::to_tick(clock::time_point time, bool round_up) const
+{
+    if (time <= start_) {
+        return 0;
+    }
+
+    clock::duration const elapsed = time - start_;
+    std::chrono::milliseconds const ticks = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+
+    return ticks.count() + (round_up && ticks < elapsed ? 1 : 0);
+}
+
+
+uint64_t timer_wheel::prefix(uint64_t tick, unsigned level)
+{
+    unsigned const shift = level * SLOT_BITS;
+    return shift < 64 ? tick >> shift : 0;
+}
+
+
+void timer_wheel::push_back(list & target, uint16_t list_id, uint32_t index)
+{
+    node & n = nodes_[index];
+    n.list = list_id;
+    n.prev = target.tail;
+    n.next = NIL;
+
+    if (target.tail != NIL) {
+        nodes_[target.tail].next = index;
+    }
+    else {
+        target.head = index;
+    }
+
+    target.tail = index;
+}
+
+
+void timer_wheel::unlink(uint32_t index)
+{
+    node & n = nodes_[index];
+    list & source = list_for(n.list);
+
+    if (n.prev != NIL) {
+        nodes_[n.prev].next = n.next;
+    }
+    else {
+        source.head = n.next;
+    }
+
+    if (n.next != NIL) {
+        nodes_[n.next].prev = n.prev;
+    }
+    else {
+        source.tail = n.prev;
+    }
+
+    if (n.list < LEVELS * SLOTS && source.head == NIL) {
+        occupied_[n.list / SLOTS] &= ~(uint64_t(1) << (n.list % SLOTS));
+    }
+
+    n.list = NO_LIST;
+}
+
+
+timer_wheel::list & timer_wheel::list_for(uint16_t list_id)
+{
+    switch (list_id) {
+        case EXPIRED_LIST:
+            return expired_;
+
+        case RUNNING_LIST:
+            return running_;
+
+        default:
+            return slots_[list_id / SLOTS][list_id % SLOTS];
+    }
+}
+
+
+void timer_wheel::free_node(uint32_t index)
+{
+    node & n = nodes_[index];
+    n.list = NO_LIST;
+    n.callback = nullptr;
+    n.next = free_;
+    free_ = index;
+
+    if (++n.generation == 0) {
+        n.generation = 1;
+    }
+
+    --size_;
+}
@@ -0,0 +1,23 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__trigger_mode__hpp
+#define meridian__reactor__trigger_mode__hpp
+
+#include <cstdint>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief How a reactor reports readiness for an event_source.
+
+enum class trigger_mode : std::uint8_t {
+    level, //!< callbacks are invoked for as long as the descriptor is ready (the default)
+    edge   //!< callbacks are invoked only when the descriptor becomes ready; they must drain it or re-arm
+};
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__trigger_mode__hpp */
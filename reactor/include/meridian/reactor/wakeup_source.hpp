@@ -0,0 +1,69 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__wakeup_source__hpp
+#define meridian__reactor__wakeup_source__hpp
+
+#include "meridian/core/event_source.hpp"
+
+#include <cstdint>
+
+namespace meridian {
+namespace reactor {
+
+//! \brief An event_source which other threads can make readable, built on Linux's \c eventfd (2) where available.
+//! \class wakeup_source wakeup_source.hpp meridian/reactor/wakeup_source.hpp
+//!
+//! A wakeup_source holds a 64-bit counter. notify() adds to it and may be called from any thread (or a signal
+//! handler); the descriptor is readable while the counter is non-zero. consume(), called from the readable callback,
+//! returns the counter and resets it to zero, so any number of notifications made before the callback runs are
+//! collapsed into a single wakeup. In semaphore mode, consume() instead decrements the counter by one and returns 1,
+//! and the callback runs once per notification.
+//!
+//! On Linux this replaces the self-pipe trick: one descriptor instead of two, and an 8-byte counter in place of a pipe
+//! buffer which can fill up. Elsewhere, a non-blocking pipe stands in, holding one byte per notification; should the
+//! pipe fill, further notifications are dropped (the wakeup_source is readable regardless), so consume() may then
+//! return less than the number of notifications. The descriptors are close-on-exec, and are closed on destruction.
+//!
+//! \author Eric Crampton
+
+class wakeup_source : public core::event_source {
+public:
+    //! \brief Construction.
+    //!
+    //! \param semaphore - true to consume notifications one at a time (\c EFD_SEMAPHORE)
+
+    explicit wakeup_source(bool semaphore = false);
+
+    //! \brief Destruction; closes the descriptor.
+
+    ~wakeup_source();
+
+    wakeup_source(wakeup_source const & source) = delete;
+    wakeup_source & operator=(wakeup_source const & source) = delete;
+
+    //! \brief Adds \a count to the counter, making the wakeup_source readable. Thread-safe and async-signal-safe.
+    //!
+    //! If the counter is so large that adding \a count would overflow it, the wakeup_source is already readable, and
+    //! the notification is dropped rather than blocking or failing.
+
+    void notify(uint64_t count = 1) noexcept;
+
+    //! \brief Takes the counter (or, in semaphore mode, one notification).
+    //!
+    //! \return the value taken, or 0 if there were no notifications
+
+    uint64_t consume();
+
+private:
+#if !defined(__linux__)
+    int write_fd_;
+    bool semaphore_;
+#endif
+};
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* meridian__reactor__wakeup_source__hpp */
@@ -0,0 +1,275 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/epoll_reactor.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#include <unistd.h>
+
+namespace {
+
+size_t const INITIAL_EVENT_CAPACITY = 64;
+
+}
+
+namespace meridian {
+namespace reactor {
+
+epoll_reactor::epoll_reactor()
+    : epoll_reactor(std::unique_ptr<core::abstract_event_source_registry>(new core::event_source_registry))
+{
+}
+
+
+epoll_reactor::epoll_reactor(std::unique_ptr<core::abstract_event_source_registry> registry)
+    : posted_()
+    , registry_(registry.release())
+    , epoll_fd_(::epoll_create1(EPOLL_CLOEXEC))
+    , fd_states_()
+    , dirty_fds_()
+    , events_(INITIAL_EVENT_CAPACITY)
+    , timers_()
+{
+    if (epoll_fd_ < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("epoll_create1");
+    }
+
+    register_read_callback(posted_.source(), [this] { posted_.run(); });
+}
+
+
+epoll_reactor::~epoll_reactor()
+{
+    ::close(epoll_fd_);
+}
+
+
+void epoll_reactor::register_read_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_read_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void epoll_reactor::register_write_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_write_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void epoll_reactor::register_except_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_except_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void epoll_reactor::remove_read_callback(core::event_source & source)
+{
+    registry_->remove_read_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void epoll_reactor::remove_write_callback(core::event_source & source)
+{
+    registry_->remove_write_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void epoll_reactor::remove_except_callback(core::event_source & source)
+{
+    registry_->remove_except_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void epoll_reactor::register_handler(
+        core::event_source & source,
+        core::event_source::event_handler handler,
+        core::event_source::event_mask interest)
+{
+    assert(handler);
+    registry_->register_handler(source, std::move(handler), interest);
+    mark_dirty(source.fd());
+}
+
+
+void epoll_reactor::set_interest(core::event_source & source, core::event_source::event_mask interest)
+{
+    registry_->set_interest(source, interest);
+    mark_dirty(source.fd());
+}
+
+
+void epoll_reactor::remove_handler(core::event_source & source)
+{
+    registry_->remove_handler(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void epoll_reactor::set_trigger_mode(core::event_source & source, trigger_mode mode)
+{
+    mark_dirty(source.fd());
+    fd_states_[source.fd()].edge_triggered = mode == trigger_mode::edge;
+}
+
+
+void epoll_reactor::rearm(core::event_source & source)
+{
+    assert(source.has_callback());
+    mark_dirty(source.fd());
+    fd_states_[source.fd()].rearm = true;
+}
+
+
+timer_wheel::timer_id epoll_reactor::schedule_after(clock::duration delay, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_after(delay, std::move(callback));
+}
+
+
+timer_wheel::timer_id epoll_reactor::schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_at(deadline, std::move(callback));
+}
+
+
+bool epoll_reactor::cancel(timer_id timer)
+{
+    return timers_.cancel(timer);
+}
+
+
+void epoll_reactor::post(post_queue::posted_callback callback)
+{
+    posted_.post(std::move(callback));
+}
+
+
+void epoll_reactor::wait_for_events()
+{
+    flush_interest_changes();
+
+    int result = ::epoll_wait(epoll_fd_, events_.data(), events_.size(), timers_.timeout(clock::now(), 5000));
+    if (result < 0) {
+        if (errno == EINTR) {
+            timers_.expire();
+            return;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("epoll_wait");
+    }
+
+    for (int i = 0; i < result; ++i) {
+        int const fd = events_[i].data.fd;
+        uint32_t const events = events_[i].events;
+
+        // Callbacks may remove registrations (or destroy sources outright), so the source is looked up afresh before
+        // each callback rather than held across them. A unified handler gets every ready event in one call instead.
+
+        core::event_source * source = registry_->find(fd);
+        if (source && source->has_handler()) {
+            core::event_source::event_mask const ready = ready_mask(events) & source->interest();
+            if (ready) {
+                source->invoke_handler(ready);
+            }
+            continue;
+        }
+
+        if (source && (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && source->has_read_callback()) {
+            source->invoke_read_callback();
+            source = registry_->find(fd);
+        }
+
+        if (source && (events & (EPOLLOUT | EPOLLERR)) && source->has_write_callback()) {
+            source->invoke_write_callback();
+            source = registry_->find(fd);
+        }
+
+        if (source && (events & EPOLLPRI) && source->has_except_callback()) {
+            source->invoke_except_callback();
+        }
+    }
+
+    if (static_cast<size_t>(result) == events_.size()) {
+        events_.resize(events_.size() * 2);
+    }
+
+    timers_.expire();
+}
+
+
+void epoll_reactor::flush_interest_changes()
+{
+    for (int fd : dirty_fds_) {
+        fd_state & state = fd_states_[fd];
+        uint32_t const desired = desired_events(fd);
+
+        if (desired != state.kernel_events || (desired && state.rearm)) {
+            control(fd, state.kernel_events, desired);
+            state.kernel_events = desired;
+        }
+
+        state.dirty = false;
+        state.rearm = false;
+    }
+
+    dirty_fds_.clear();
+}
+
+
+void epoll_reactor::control(int fd, uint32_t current, uint32_t desired)
+{
+    epoll_event event{};
+    event.events = desired;
+    event.data.fd = fd;
+
+    if (!desired) {
+        // The descriptor may already have been closed, which removes it from the interest list implicitly.
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event) < 0 && errno != ENOENT && errno != EBADF) {
+            throw exception()
+                << boost::errinfo_errno(errno)
+                << boost::errinfo_api_function("epoll_ctl");
+        }
+        return;
+    }
+
+    int op = current ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (::epoll_ctl(epoll_fd_, op, fd, &event) < 0) {
+        // A closed and reused descriptor leaves our view out of step with the kernel's; retry with the other op.
+        if (op == EPOLL_CTL_MOD && errno == ENOENT) {
+            op = EPOLL_CTL_ADD;
+        }
+        else if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+            op = EPOLL_CTL_MOD;
+        }
+        else {
+            op = -1;
+        }
+
+        if (op < 0 || ::epoll_ctl(epoll_fd_, op, fd, &event) < 0) {
+            throw exception()
+                << boost::errinfo_errno(errno)
+                << boost::errinfo_api_function("epoll_ctl");
+        }
+    }
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,74 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/io_uring_buffer_group.hpp"
+#include "meridian/reactor/exception.hpp"
+
+namespace meridian {
+namespace reactor {
+
+io_uring_buffer_group::io_uring_buffer_group(
+        io_uring_reactor & reactor,
+        uint16_t id,
+        unsigned count,
+        size_t buffer_size)
+    : reactor_(reactor)
+    , id_(id)
+    , count_(count)
+    , buffer_size_(buffer_size)
+    , buffers_()
+{
+    if (!count || count > 65536) {
+        throw unsupported_operation_exception()
+            << core::exception_message("buffer group size must be between 1 and 65536");
+    }
+
+    buffers_.reset(new char[count * buffer_size]);
+
+    io_uring_sqe * sqe = reactor_.get_sqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = count_;
+    sqe->addr = reinterpret_cast<uint64_t>(buffers_.get());
+    sqe->len = buffer_size_;
+    sqe->off = 0;
+    sqe->buf_group = id_;
+    sqe->user_data = io_uring_reactor::IGNORED_USER_DATA;
+}
+
+
+io_uring_buffer_group::~io_uring_buffer_group()
+{
+    io_uring_sqe * sqe = reactor_.get_sqe();
+    sqe->opcode = IORING_OP_REMOVE_BUFFERS;
+    sqe->fd = count_;
+    sqe->buf_group = id_;
+    sqe->user_data = io_uring_reactor::IGNORED_USER_DATA;
+
+    // Removal completes during submission, so once this returns the kernel no longer refers to the buffers.
+    try {
+        reactor_.queue_.enter(0, nullptr);
+    }
+    catch (...) {
+    }
+}
+
+
+void io_uring_buffer_group::recycle(uint16_t buffer_id)
+{
+    io_uring_sqe * sqe = reactor_.get_sqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer(buffer_id));
+    sqe->len = buffer_size_;
+    sqe->off = buffer_id;
+    sqe->buf_group = id_;
+    sqe->user_data = io_uring_reactor::IGNORED_USER_DATA;
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
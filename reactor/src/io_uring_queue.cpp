@@ -0,0 +1,158 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/io_uring_queue.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+template <typename T>
+T * ring_pointer(void * ring, unsigned offset)
+{
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}
+
+namespace meridian {
+namespace reactor {
+
+io_uring_queue::io_uring_queue(unsigned entries)
+    : ring_fd_(-1)
+    , features_(0)
+    , ring_(MAP_FAILED)
+    , ring_size_(0)
+    , sqes_(static_cast<io_uring_sqe *>(MAP_FAILED))
+    , sqes_size_(0)
+    , sq_local_tail_(0)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    ring_fd_ = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd_ < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("io_uring_setup");
+    }
+
+    features_ = params.features;
+    if (!(features_ & IORING_FEAT_SINGLE_MMAP) || !(features_ & IORING_FEAT_EXT_ARG)) {
+        ::close(ring_fd_);
+        throw unsupported_operation_exception()
+            << core::exception_message("io_uring lacks IORING_FEAT_SINGLE_MMAP or IORING_FEAT_EXT_ARG");
+    }
+
+    ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                          params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ == MAP_FAILED) {
+        int error = errno;
+        ::close(ring_fd_);
+        throw exception()
+            << boost::errinfo_errno(error)
+            << boost::errinfo_api_function("mmap");
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(
+            ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+        int error = errno;
+        ::munmap(ring_, ring_size_);
+        ::close(ring_fd_);
+        throw exception()
+            << boost::errinfo_errno(error)
+            << boost::errinfo_api_function("mmap");
+    }
+
+    sq_head_    = ring_pointer<unsigned>(ring_, params.sq_off.head);
+    sq_tail_    = ring_pointer<unsigned>(ring_, params.sq_off.tail);
+    sq_mask_    = *ring_pointer<unsigned>(ring_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+
+    // Submission queue entries are always used in order, so the indirection array is fixed as the identity mapping.
+    unsigned * sq_array = ring_pointer<unsigned>(ring_, params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries_; ++i) {
+        sq_array[i] = i;
+    }
+
+    sq_local_tail_ = *sq_tail_;
+
+    cq_head_ = ring_pointer<unsigned>(ring_, params.cq_off.head);
+    cq_tail_ = ring_pointer<unsigned>(ring_, params.cq_off.tail);
+    cq_mask_ = *ring_pointer<unsigned>(ring_, params.cq_off.ring_mask);
+    cqes_    = ring_pointer<io_uring_cqe>(ring_, params.cq_off.cqes);
+}
+
+
+io_uring_queue::~io_uring_queue()
+{
+    ::munmap(sqes_, sqes_size_);
+    ::munmap(ring_, ring_size_);
+    ::close(ring_fd_);
+}
+
+
+io_uring_sqe * io_uring_queue::get_sqe()
+{
+    unsigned const head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sq_local_tail_ - head >= sq_entries_) {
+        return nullptr;
+    }
+
+    io_uring_sqe * sqe = &sqes_[sq_local_tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sq_local_tail_;
+
+    return sqe;
+}
+
+
+bool io_uring_queue::enter(unsigned min_complete, timespec const * timeout)
+{
+    unsigned const to_submit = pending();
+    __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+
+    unsigned flags = 0;
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+
+    if (min_complete) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(timeout);
+    }
+
+    int result = ::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags,
+                           min_complete ? &arg : nullptr, sizeof(arg));
+
+    // A timed out or interrupted wait isn't an error, and neither is the kernel refusing new work until completions
+    // are reaped (EBUSY/EAGAIN): whatever wasn't consumed remains pending and is submitted by the next call.
+    if (result < 0 && errno != ETIME && errno != EINTR) {
+        if (errno == EBUSY || errno == EAGAIN) {
+            return false;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("io_uring_enter");
+    }
+
+    return true;
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,307 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/io_uring_reactor.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#include <cerrno>
+
+namespace meridian {
+namespace reactor {
+
+uint64_t const io_uring_reactor::IGNORED_USER_DATA;
+
+
+io_uring_reactor::io_uring_reactor(unsigned entries)
+    : io_uring_reactor(std::unique_ptr<core::abstract_event_source_registry>(new core::event_source_registry), entries)
+{
+}
+
+
+io_uring_reactor::io_uring_reactor(std::unique_ptr<core::abstract_event_source_registry> registry, unsigned entries)
+    : posted_()
+    , registry_(registry.release())
+    , queue_(entries)
+    , fd_states_()
+    , dirty_fds_()
+    , deferred_completions_()
+    , timers_()
+{
+    register_read_callback(posted_.source(), [this] { posted_.run(); });
+}
+
+
+void io_uring_reactor::register_read_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_read_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void io_uring_reactor::register_write_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_write_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void io_uring_reactor::register_except_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_except_callback(source, std::move(callback));
+    mark_dirty(source.fd());
+}
+
+
+void io_uring_reactor::remove_read_callback(core::event_source & source)
+{
+    registry_->remove_read_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void io_uring_reactor::remove_write_callback(core::event_source & source)
+{
+    registry_->remove_write_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void io_uring_reactor::remove_except_callback(core::event_source & source)
+{
+    registry_->remove_except_callback(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void io_uring_reactor::register_handler(
+        core::event_source & source,
+        core::event_source::event_handler handler,
+        core::event_source::event_mask interest)
+{
+    assert(handler);
+    registry_->register_handler(source, std::move(handler), interest);
+    mark_dirty(source.fd());
+}
+
+
+void io_uring_reactor::set_interest(core::event_source & source, core::event_source::event_mask interest)
+{
+    registry_->set_interest(source, interest);
+    mark_dirty(source.fd());
+}
+
+
+void io_uring_reactor::remove_handler(core::event_source & source)
+{
+    registry_->remove_handler(source);
+    mark_dirty_after_remove(source);
+}
+
+
+void io_uring_reactor::set_trigger_mode(core::event_source & source, trigger_mode mode)
+{
+    mark_dirty(source.fd());
+    fd_states_[source.fd()].edge_triggered = mode == trigger_mode::edge;
+}
+
+
+void io_uring_reactor::rearm(core::event_source & source)
+{
+    assert(source.has_callback());
+    mark_dirty(source.fd());
+    fd_states_[source.fd()].rearm = true;
+}
+
+
+io_uring_sqe * io_uring_reactor::prepare(io_uring_operation & operation)
+{
+    io_uring_sqe * sqe = get_sqe();
+    sqe->user_data = reinterpret_cast<uint64_t>(&operation);
+
+    return sqe;
+}
+
+
+timer_wheel::timer_id io_uring_reactor::schedule_after(clock::duration delay, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_after(delay, std::move(callback));
+}
+
+
+timer_wheel::timer_id io_uring_reactor::schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_at(deadline, std::move(callback));
+}
+
+
+bool io_uring_reactor::cancel(timer_id timer)
+{
+    return timers_.cancel(timer);
+}
+
+
+void io_uring_reactor::post(post_queue::posted_callback callback)
+{
+    posted_.post(std::move(callback));
+}
+
+
+void io_uring_reactor::wait_for_events()
+{
+    flush_interest_changes();
+
+    if (!queue_.has_completions() && deferred_completions_.empty()) {
+        int const milliseconds = timers_.timeout(clock::now(), 5000);
+        timespec timeout{ milliseconds / 1000, (milliseconds % 1000) * 1000000L };
+        queue_.enter(1, &timeout);
+    }
+    else if (queue_.pending()) {
+        queue_.enter(0, nullptr);
+    }
+
+    // Completions reaped while submitting come first. Dispatching them may defer more, so they're copied out one at a
+    // time rather than referred to in place.
+    for (size_t i = 0; i < deferred_completions_.size(); ++i) {
+        io_uring_cqe const cqe = deferred_completions_[i];
+        dispatch(cqe);
+    }
+    deferred_completions_.clear();
+
+    queue_.for_each_completion([this](io_uring_cqe const & cqe) { dispatch(cqe); });
+    timers_.expire();
+}
+
+
+void io_uring_reactor::flush_interest_changes()
+{
+    for (int fd : dirty_fds_) {
+        fd_state & state = fd_states_[fd];
+        core::event_source const * source = registry_->find(fd);
+        uint32_t const desired = source ? interest_mask(*source) : 0;
+        bool const multishot = state.edge_triggered;
+        bool const rearm = state.rearm;
+
+        state.dirty = false;
+        state.rearm = false;
+        if (desired == state.armed_events && (!desired || (multishot == state.armed_multishot && !rearm))) {
+            continue;
+        }
+
+        // The armed request is cancelled by user_data rather than by descriptor, so this is correct even if the
+        // descriptor has since been closed and reused.
+        if (state.armed_events) {
+            io_uring_sqe * sqe = get_sqe();
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = poll_user_data(fd, state.generation);
+            sqe->user_data = IGNORED_USER_DATA;
+        }
+
+        if (++state.generation == 0) {
+            state.generation = 1;
+        }
+
+        if (desired) {
+            io_uring_sqe * sqe = get_sqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = fd;
+            sqe->poll32_events = desired;
+            sqe->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+            sqe->user_data = poll_user_data(fd, state.generation);
+        }
+
+        state.armed_events = desired;
+        state.armed_multishot = multishot;
+    }
+
+    dirty_fds_.clear();
+}
+
+
+io_uring_sqe * io_uring_reactor::get_sqe()
+{
+    io_uring_sqe * sqe = queue_.get_sqe();
+
+    // If the kernel refuses new work until the completion ring has room, completions are moved out of the ring to be
+    // dispatched by wait_for_events(). They can't be dispatched here: the caller may be part way through a flush.
+    while (!sqe) {
+        if (!queue_.enter(0, nullptr)) {
+            queue_.for_each_completion([this](io_uring_cqe const & cqe) { deferred_completions_.push_back(cqe); });
+        }
+
+        sqe = queue_.get_sqe();
+    }
+
+    return sqe;
+}
+
+
+void io_uring_reactor::dispatch(io_uring_cqe const & cqe)
+{
+    if (cqe.user_data == IGNORED_USER_DATA) {
+        return;
+    }
+
+    if (!(cqe.user_data & 1)) {
+        reinterpret_cast<io_uring_operation *>(cqe.user_data)->complete(cqe);
+        return;
+    }
+
+    int const fd = static_cast<int>((cqe.user_data & 0xffffffff) >> 1);
+    uint32_t const generation = static_cast<uint32_t>(cqe.user_data >> 32);
+
+    if (static_cast<size_t>(fd) >= fd_states_.size() || fd_states_[fd].generation != generation) {
+        return;
+    }
+
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        // Either a one-shot (level-triggered) request completed, or the kernel terminated a multishot request (e.g.,
+        // on error). Either way, nothing is armed any more; the next flush arms a new request if still wanted. That
+        // is, unless the descriptor can't be polled at all (e.g., it was closed without its registration being
+        // removed): a new request would only fail again, so none is armed until the registration next changes.
+        fd_states_[fd].armed_events = 0;
+        if (cqe.res != -EBADF && cqe.res != -EINVAL) {
+            mark_dirty(fd);
+        }
+    }
+
+    // A failed request is reported as POLLERR, just as epoll reports a descriptor in error.
+    uint32_t const events = cqe.res < 0 ? POLLERR : cqe.res;
+
+    // As in epoll_reactor, callbacks may remove registrations or destroy sources, so the source is looked up afresh
+    // before each callback.
+
+    core::event_source * source = registry_->find(fd);
+    if (source && source->has_handler()) {
+        core::event_source::event_mask const ready = ready_mask(events) & source->interest();
+        if (ready) {
+            source->invoke_handler(ready);
+        }
+        return;
+    }
+
+    if (source && (events & (POLLIN | POLLHUP | POLLERR)) && source->has_read_callback()) {
+        source->invoke_read_callback();
+        source = registry_->find(fd);
+    }
+
+    if (source && (events & (POLLOUT | POLLERR)) && source->has_write_callback()) {
+        source->invoke_write_callback();
+        source = registry_->find(fd);
+    }
+
+    if (source && (events & POLLPRI) && source->has_except_callback()) {
+        source->invoke_except_callback();
+    }
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
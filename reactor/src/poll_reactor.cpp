@@ -0,0 +1,187 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/reactor/poll_reactor.hpp"
+#include "meridian/reactor/exception.hpp"
+
+namespace meridian {
+namespace reactor {
+
+int const poll_reactor::NO_SLOT;
+
+
+poll_reactor::poll_reactor()
+    : posted_()
+    , registry_(new core::event_source_registry)
+{
+    register_read_callback(posted_.source(), [this] { posted_.run(); });
+}
+
+
+poll_reactor::poll_reactor(std::unique_ptr<core::abstract_event_source_registry> registry)
+    : posted_()
+    , registry_(registry.release())
+{
+    register_read_callback(posted_.source(), [this] { posted_.run(); });
+}
+
+
+void poll_reactor::register_read_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_read_callback(source, std::move(callback));
+    add_events(source.fd(), POLLIN);
+}
+
+
+void poll_reactor::register_write_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_write_callback(source, std::move(callback));
+    add_events(source.fd(), POLLOUT);
+}
+
+
+void poll_reactor::register_except_callback(core::event_source & source, core::event_source::event_callback callback)
+{
+    assert(callback);
+    registry_->register_except_callback(source, std::move(callback));
+    add_events(source.fd(), POLLPRI);
+}
+
+
+void poll_reactor::remove_read_callback(core::event_source & source)
+{
+    registry_->remove_read_callback(source);
+    remove_events(source.fd(), POLLIN);
+}
+
+
+void poll_reactor::remove_write_callback(core::event_source & source)
+{
+    registry_->remove_write_callback(source);
+    remove_events(source.fd(), POLLOUT);
+}
+
+
+void poll_reactor::remove_except_callback(core::event_source & source)
+{
+    registry_->remove_except_callback(source);
+    remove_events(source.fd(), POLLPRI);
+}
+
+
+void poll_reactor::register_handler(
+        core::event_source & source,
+        core::event_source::event_handler handler,
+        core::event_source::event_mask interest)
+{
+    assert(handler);
+    registry_->register_handler(source, std::move(handler), interest);
+    set_events(source.fd(), poll_events(interest));
+}
+
+
+void poll_reactor::set_interest(core::event_source & source, core::event_source::event_mask interest)
+{
+    registry_->set_interest(source, interest);
+    set_events(source.fd(), poll_events(interest));
+}
+
+
+void poll_reactor::remove_handler(core::event_source & source)
+{
+    registry_->remove_handler(source);
+    remove_events(source.fd(), POLLIN | POLLOUT | POLLPRI);
+}
+
+
+timer_wheel::timer_id poll_reactor::schedule_after(clock::duration delay, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_after(delay, std::move(callback));
+}
+
+
+timer_wheel::timer_id poll_reactor::schedule_at(clock::time_point deadline, timer_wheel::timer_callback callback)
+{
+    return timers_.schedule_at(deadline, std::move(callback));
+}
+
+
+bool poll_reactor::cancel(timer_id timer)
+{
+    return timers_.cancel(timer);
+}
+
+
+void poll_reactor::post(post_queue::posted_callback callback)
+{
+    posted_.post(std::move(callback));
+}
+
+
+void poll_reactor::wait_for_events()
+{
+    int result = ::poll(pollfds_.data(), pollfds_.size(), timers_.timeout(clock::now(), 5000));
+    if (result < 0) {
+        if (errno == EINTR) {
+            timers_.expire();
+            return;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("poll");
+    }
+
+    // Callbacks may register and remove, which reorders pollfds_, so the ready entries are collected before any
+    // callback runs. The scan stops as soon as all of them have been found.
+
+    ready_.clear();
+    for (auto it = pollfds_.begin(); result && it != pollfds_.end(); ++it) {
+        if (it->revents) {
+            ready_.emplace_back(it->fd, it->revents);
+            --result;
+        }
+    }
+
+    for (auto const & ready : ready_) {
+        int const fd = ready.first;
+        short const events = ready.second;
+
+        // As in epoll_reactor, callbacks may remove registrations or destroy sources, so the source is looked up
+        // afresh before each callback.
+
+        core::event_source * source = registry_->find(fd);
+        if (source && source->has_handler()) {
+            core::event_source::event_mask const ready = ready_mask(events) & source->interest();
+            if (ready) {
+                source->invoke_handler(ready);
+            }
+            continue;
+        }
+
+        // POLLNVAL, a registered descriptor which has been closed, is an error like POLLERR; otherwise it would be
+        // reported, and ignored, by every poll() until the registration is removed.
+
+        if (source && (events & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) && source->has_read_callback()) {
+            source->invoke_read_callback();
+            source = registry_->find(fd);
+        }
+
+        if (source && (events & (POLLOUT | POLLERR | POLLNVAL)) && source->has_write_callback()) {
+            source->invoke_write_callback();
+            source = registry_->find(fd);
+        }
+
+        if (source && (events & POLLPRI) && source->has_except_callback()) {
+            source->invoke_except_callback();
+        }
+    }
+
+    timers_.expire();
+}
+
+} // namespace reactor
+} // namespace meridian
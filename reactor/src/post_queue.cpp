@@ -0,0 +1,248 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/reactor/post_queue.hpp"
+
+namespace meridian {
+namespace reactor {
+
+//! \brief One posting thread's free list of nodes.
+//!
+//! The owning thread pops nodes from free_ without synchronization. Nodes come back from run(), on any thread, onto the
+//! lock-free stack returned_, which the owning thread takes whole once free_ runs dry. The cache outlives its thread
+//! until every node it allocated has come back: references_ counts the thread and each node, and when the thread exits
+//! it closes returned_, after which nodes coming back are deleted instead, the last one deleting the cache.
+
+class post_queue::node_cache {
+public:
+    //! \brief Returns this thread's cache.
+
+    static node_cache & local()
+    {
+        static thread_local owner cache;
+        return *cache.cache;
+    }
+
+    //! \brief Returns a node with an empty callback. Owning thread only.
+
+    node * acquire()
+    {
+        if (!free_) {
+            free_ = returned_.exchange(nullptr, std::memory_order_acquire);
+        }
+
+        if (!free_) {
+            node * fresh = new node { nullptr, this, nullptr };
+            references_.fetch_add(1, std::memory_order_relaxed);
+            return fresh;
+        }
+
+        node * acquired = free_;
+        free_ = acquired->next;
+        return acquired;
+    }
+
+    //! \brief Takes back the nodes from \a first to \a last. May be called from any thread.
+
+    void give_back(node * first, node * last) noexcept
+    {
+        node * head = returned_.load(std::memory_order_relaxed);
+        while (head != closed()) {
+            last->next = head;
+            if (returned_.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+
+        // The owning thread has exited.
+        last->next = nullptr;
+        release(delete_nodes(first));
+    }
+
+private:
+    //! \brief Owns a thread's cache, abandoning it when the thread exits.
+    struct owner {
+        owner()
+            : cache(new node_cache)
+        {
+        }
+
+        ~owner()
+        {
+            cache->abandon();
+        }
+
+        node_cache * cache;
+    };
+
+    node_cache()
+        : free_(nullptr)
+        , returned_(nullptr)
+        , references_(1)
+    {
+    }
+
+    //! \brief Frees the nodes on hand and closes returned_, when the owning thread exits.
+
+    void abandon() noexcept
+    {
+        node * returned = returned_.exchange(closed(), std::memory_order_acquire);
+        release(delete_nodes(free_) + delete_nodes(returned) + 1);
+    }
+
+    //! \brief Drops \a count references, deleting the cache with the last.
+
+    void release(size_t count) noexcept
+    {
+        if (references_.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            delete this;
+        }
+    }
+
+    //! \brief Deletes \a first and every node linked from it, returning how many there were.
+
+    static size_t delete_nodes(node * first) noexcept
+    {
+        size_t count = 0;
+        while (first) {
+            node * next = first->next;
+            delete first;
+            first = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+    //! \brief The value of returned_ once the owning thread has exited; never dereferenced.
+
+    static node * closed() noexcept
+    {
+        static char marker;
+        return reinterpret_cast<node *>(&marker);
+    }
+
+private:
+    static size_t const CACHE_LINE = 64;
+
+    node * free_;
+    char padding_[CACHE_LINE];
+    std::atomic<node *> returned_;
+    std::atomic<size_t> references_;
+};
+
+
+post_queue::post_queue()
+    : posted_(nullptr)
+    , batch_(nullptr)
+    , wakeup_()
+{
+}
+
+
+post_queue::~post_queue()
+{
+    destroy(batch_);
+    destroy(posted_.load(std::memory_order_acquire));
+}
+
+
+void post_queue::post(posted_callback callback)
+{
+    node * posted = node_cache::local().acquire();
+    posted->callback = std::move(callback);
+
+    node * head = posted_.load(std::memory_order_relaxed);
+    do {
+        posted->next = head;
+    } while (!posted_.compare_exchange_weak(head, posted, std::memory_order_release, std::memory_order_relaxed));
+
+    if (!head) {
+        wakeup_.notify();
+    }
+}
+
+
+size_t post_queue::run()
+{
+    // The wakeup is consumed before the stack is detached. A post() which lands in between finds the stack non-empty
+    // and doesn't notify, but its callback is in this batch; one which lands afterwards finds the stack empty and
+    // notifies again. Either way, no callback is left without a pending wakeup.
+
+    wakeup_.consume();
+    node * posted = posted_.exchange(nullptr, std::memory_order_acquire);
+
+    node * reversed = nullptr;
+    while (posted) {
+        node * next = posted->next;
+        posted->next = reversed;
+        reversed = posted;
+        posted = next;
+    }
+
+    if (batch_) {
+        node * tail = batch_;
+        while (tail->next) {
+            tail = tail->next;
+        }
+        tail->next = reversed;
+    }
+    else {
+        batch_ = reversed;
+    }
+
+    // Nodes which have been run are collected in done, and recycled together once the batch is over.
+    node * done = nullptr;
+    size_t count = 0;
+    try {
+        while (batch_) {
+            node * current = batch_;
+            batch_ = current->next;
+            current->next = done;
+            done = current;
+
+            current->callback();
+            current->callback = nullptr;
+            ++count;
+        }
+    }
+    catch (...) {
+        destroy(done);
+        if (batch_) {
+            wakeup_.notify();
+        }
+        throw;
+    }
+
+    recycle(done);
+    return count;
+}
+
+
+void post_queue::destroy(node * first) noexcept
+{
+    for (node * current = first; current; current = current->next) {
+        current->callback = nullptr;
+    }
+
+    recycle(first);
+}
+
+
+void post_queue::recycle(node * first) noexcept
+{
+    while (first) {
+        node * last = first;
+        while (last->next && last->next->home == first->home) {
+            last = last->next;
+        }
+
+        node * rest = last->next;
+        first->home->give_back(first, last);
+        first = rest;
+    }
+}
+
+} // namespace reactor
+} // namespace meridian
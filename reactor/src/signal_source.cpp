@@ -0,0 +1,81 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/signal_source.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace meridian {
+namespace reactor {
+
+signal_source::signal_source(sigset_t const & signals)
+    : core::event_source(-1)
+{
+    init(signals);
+}
+
+
+signal_source::signal_source(std::initializer_list<int> signals)
+    : core::event_source(-1)
+{
+    sigset_t set;
+    ::sigemptyset(&set);
+
+    for (int signal : signals) {
+        ::sigaddset(&set, signal);
+    }
+
+    init(set);
+}
+
+
+signal_source::~signal_source()
+{
+    ::close(fd());
+}
+
+
+bool signal_source::read_signal(signalfd_siginfo & info)
+{
+    if (::read(fd(), &info, sizeof(info)) < 0) {
+        if (errno == EAGAIN) {
+            return false;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("read");
+    }
+
+    return true;
+}
+
+
+void signal_source::init(sigset_t const & signals)
+{
+    int error = ::pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    if (error) {
+        throw exception()
+            << boost::errinfo_errno(error)
+            << boost::errinfo_api_function("pthread_sigmask");
+    }
+
+    int fd = ::signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("signalfd");
+    }
+
+    reset_fd(fd);
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,99 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__linux__)
+
+#include "meridian/reactor/timer_source.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#include <algorithm>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+
+timespec to_timespec(std::chrono::nanoseconds value)
+{
+    timespec result;
+    result.tv_sec = value.count() / 1000000000;
+    result.tv_nsec = value.count() % 1000000000;
+    return result;
+}
+
+}
+
+namespace meridian {
+namespace reactor {
+
+timer_source::timer_source()
+    : core::event_source(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+{
+    if (fd() < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("timerfd_create");
+    }
+}
+
+
+timer_source::~timer_source()
+{
+    ::close(fd());
+}
+
+
+void timer_source::set_after(clock::duration delay, clock::duration interval)
+{
+    // An it_value of zero would disarm the timer, so the shortest delay is rounded up to a nanosecond.
+    set(0, std::max(delay, clock::duration(std::chrono::nanoseconds(1))), interval);
+}
+
+
+void timer_source::set_at(clock::time_point deadline, clock::duration interval)
+{
+    clock::duration const since_epoch = deadline.time_since_epoch();
+    set(TFD_TIMER_ABSTIME, std::max(since_epoch, clock::duration(std::chrono::nanoseconds(1))), interval);
+}
+
+
+void timer_source::disarm()
+{
+    set(0, clock::duration::zero(), clock::duration::zero());
+}
+
+
+uint64_t timer_source::read_expirations()
+{
+    uint64_t expirations = 0;
+    if (::read(fd(), &expirations, sizeof(expirations)) < 0) {
+        if (errno == EAGAIN) {
+            return 0;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("read");
+    }
+
+    return expirations;
+}
+
+
+void timer_source::set(int flags, clock::duration value, clock::duration interval)
+{
+    itimerspec spec;
+    spec.it_value = to_timespec(value);
+    spec.it_interval = to_timespec(interval);
+
+    if (::timerfd_settime(fd(), flags, &spec, nullptr) < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("timerfd_settime");
+    }
+}
+
+} // namespace reactor
+} // namespace meridian
+
+#endif /* defined(__linux__) */
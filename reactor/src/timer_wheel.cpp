@@ -0,0 +1,225 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/reactor/timer_wheel.hpp"
+
+namespace meridian {
+namespace reactor {
+
+unsigned const timer_wheel::SLOT_BITS;
+unsigned const timer_wheel::SLOTS;
+unsigned const timer_wheel::LEVELS;
+uint32_t const timer_wheel::NIL;
+uint16_t const timer_wheel::NO_LIST;
+uint16_t const timer_wheel::EXPIRED_LIST;
+uint16_t const timer_wheel::RUNNING_LIST;
+
+
+timer_wheel::timer_wheel(clock::time_point start)
+    : start_(start)
+    , now_(0)
+    , size_(0)
+    , nodes_()
+    , free_(NIL)
+    , expired_{ NIL, NIL }
+    , running_{ NIL, NIL }
+{
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        occupied_[level] = 0;
+
+        for (unsigned slot = 0; slot < SLOTS; ++slot) {
+            slots_[level][slot] = list{ NIL, NIL };
+        }
+    }
+}
+
+
+timer_wheel::timer_id timer_wheel::schedule_at(clock::time_point deadline, timer_callback callback)
+{
+    uint32_t index = free_;
+    if (index != NIL) {
+        free_ = nodes_[index].next;
+    }
+    else {
+        index = nodes_.size();
+        nodes_.push_back(node());
+        nodes_.back().generation = 1;
+    }
+
+    node & n = nodes_[index];
+    n.expiry = to_tick(deadline, true);
+    n.callback = std::move(callback);
+    ++size_;
+
+    insert(index);
+
+    return (static_cast<uint64_t>(n.generation) << 32) | index;
+}
+
+
+bool timer_wheel::cancel(timer_id timer)
+{
+    uint32_t const index = static_cast<uint32_t>(timer);
+    uint32_t const generation = static_cast<uint32_t>(timer >> 32);
+
+    if (index >= nodes_.size() || nodes_[index].generation != generation || nodes_[index].list == NO_LIST) {
+        return false;
+    }
+
+    unlink(index);
+    free_node(index);
+    return true;
+}
+
+
+int timer_wheel::timeout(clock::time_point now, int maximum) const
+{
+    if (expired_.head != NIL || running_.head != NIL) {
+        return 0;
+    }
+
+    // Timers on a lower level always expire before those on a higher one, and within a level the occupied slots all
+    // lie ahead of the current tick, so the lowest occupied slot of the lowest occupied level holds the next deadline.
+    // Above level 0 a slot spans many ticks; the wait ends when the slot begins, at which point expire() moves its
+    // timers down a level and the next wait is computed from there.
+
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        if (!occupied_[level]) {
+            continue;
+        }
+
+        unsigned const slot = __builtin_ctzll(occupied_[level]);
+        unsigned const upper_shift = (level + 1) * SLOT_BITS;
+        uint64_t const upper = upper_shift < 64 ? (now_ >> upper_shift) << upper_shift : 0;
+        uint64_t const wake = upper | (static_cast<uint64_t>(slot) << (level * SLOT_BITS));
+        uint64_t const current = to_tick(now, false);
+
+        if (wake <= current) {
+            return 0;
+        }
+
+        return wake - current < static_cast<uint64_t>(maximum) ? static_cast<int>(wake - current) : maximum;
+    }
+
+    return maximum;
+}
+
+
+size_t timer_wheel::expire(clock::time_point now)
+{
+    uint64_t const tick = to_tick(now, false);
+    if (tick > now_) {
+        advance(tick);
+    }
+
+    // The expired list is moved to the running list before any callback is called, so timers which callbacks schedule
+    // for the past wait for the next expire(). Anything left running by a callback which threw is called first.
+
+    for (uint32_t index = expired_.head; index != NIL; index = nodes_[index].next) {
+        nodes_[index].list = RUNNING_LIST;
+    }
+
+    if (running_.tail != NIL) {
+        if (expired_.head != NIL) {
+            nodes_[running_.tail].next = expired_.head;
+            nodes_[expired_.head].prev = running_.tail;
+            running_.tail = expired_.tail;
+        }
+    }
+    else {
+        running_ = expired_;
+    }
+
+    expired_ = list{ NIL, NIL };
+
+    size_t count = 0;
+    while (running_.head != NIL) {
+        uint32_t const index = running_.head;
+        unlink(index);
+
+        // The node is freed before the call, so a callback which cancels its own timer is harmlessly told it had
+        // already expired, and the node may be reused by any timer the callback schedules.
+
+        timer_callback callback(std::move(nodes_[index].callback));
+        free_node(index);
+
+        callback();
+        ++count;
+    }
+
+    return count;
+}
+
+
+void timer_wheel::insert(uint32_t index)
+{
+    node & n = nodes_[index];
+
+    if (n.expiry <= now_) {
+        push_back(expired_, EXPIRED_LIST, index);
+        return;
+    }
+
+    unsigned const level = (63 - __builtin_clzll(n.expiry ^ now_)) / SLOT_BITS;
+    unsigned const slot = prefix(n.expiry, level) & (SLOTS - 1);
+
+    push_back(slots_[level][slot], level * SLOTS + slot, index);
+    occupied_[level] |= uint64_t(1) << slot;
+}
+
+
+void timer_wheel::advance(uint64_t tick)
+{
+    // A timer on level l lies in a slot past the current tick's group l, with all higher groups equal to the current
+    // tick's. Once the tick reaches its slot (or the higher groups change), the timer has either expired or belongs
+    // on a lower level, so the slots passed over are emptied and their timers re-inserted relative to the new tick.
+
+    list pending{ NIL, NIL };
+
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        uint64_t due = occupied_[level];
+        if (!due) {
+            continue;
+        }
+
+        if (prefix(tick, level + 1) == prefix(now_, level + 1)) {
+            unsigned const from = (prefix(now_, level) & (SLOTS - 1)) + 1;
+            unsigned const to = prefix(tick, level) & (SLOTS - 1);
+            if (from > to) {
+                continue;
+            }
+
+            uint64_t const through_to = to == SLOTS - 1 ? ~uint64_t(0) : (uint64_t(1) << (to + 1)) - 1;
+            due &= through_to & ~((uint64_t(1) << from) - 1);
+        }
+
+        occupied_[level] &= ~due;
+
+        for (; due; due &= due - 1) {
+            list & slot = slots_[level][__builtin_ctzll(due)];
+
+            if (pending.tail != NIL) {
+                nodes_[pending.tail].next = slot.head;
+                nodes_[slot.head].prev = pending.tail;
+            }
+            else {
+                pending.head = slot.head;
+            }
+
+            pending.tail = slot.tail;
+            slot = list{ NIL, NIL };
+        }
+    }
+
+    now_ = tick;
+
+    for (uint32_t index = pending.head; index != NIL; ) {
+        uint32_t const next = nodes_[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+} // namespace reactor
+} // namespace meridian
@@ -0,0 +1,143 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "meridian/reactor/wakeup_source.hpp"
+#include "meridian/reactor/exception.hpp"
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#else
+#include <fcntl.h>
+#endif
+#include <unistd.h>
+
+namespace meridian {
+namespace reactor {
+
+#if defined(__linux__)
+
+wakeup_source::wakeup_source(bool semaphore)
+    : core::event_source(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC | (semaphore ? EFD_SEMAPHORE : 0)))
+{
+    if (fd() < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("eventfd");
+    }
+}
+
+
+wakeup_source::~wakeup_source()
+{
+    ::close(fd());
+}
+
+
+void wakeup_source::notify(uint64_t count) noexcept
+{
+    // The only possible failure on a valid eventfd is EAGAIN, when the counter is already near its maximum.
+    ssize_t result = ::write(fd(), &count, sizeof(count));
+    (void) result;
+}
+
+
+uint64_t wakeup_source::consume()
+{
+    uint64_t value = 0;
+    if (::read(fd(), &value, sizeof(value)) < 0) {
+        if (errno == EAGAIN) {
+            return 0;
+        }
+
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("read");
+    }
+
+    return value;
+}
+
+#else
+
+wakeup_source::wakeup_source(bool semaphore)
+    : core::event_source(-1)
+    , write_fd_(-1)
+    , semaphore_(semaphore)
+{
+    int fds[2];
+    if (::pipe(fds) < 0) {
+        throw exception()
+            << boost::errinfo_errno(errno)
+            << boost::errinfo_api_function("pipe");
+    }
+
+    reset_fd(fds[0]);
+    write_fd_ = fds[1];
+
+    for (int fd : fds) {
+        if (::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) < 0 || ::fcntl(fd, F_SETFD, FD_CLOEXEC) < 0) {
+            int const error = errno;
+            ::close(fds[0]);
+            ::close(fds[1]);
+
+            throw exception()
+                << boost::errinfo_errno(error)
+                << boost::errinfo_api_function("fcntl");
+        }
+    }
+}
+
+
+wakeup_source::~wakeup_source()
+{
+    ::close(fd());
+    ::close(write_fd_);
+}
+
+
+void wakeup_source::notify(uint64_t count) noexcept
+{
+    char bytes[64] = { };
+
+    while (count) {
+        size_t const length = count < sizeof(bytes) ? count : sizeof(bytes);
+        ssize_t const result = ::write(write_fd_, bytes, length);
+        if (result <= 0) {
+            // EAGAIN: the pipe is full, so the wakeup_source is readable already.
+            return;
+        }
+
+        count -= result;
+    }
+}
+
+
+uint64_t wakeup_source::consume()
+{
+    char bytes[256];
+    uint64_t value = 0;
+
+    for (;;) {
+        ssize_t const result = ::read(fd(), bytes, semaphore_ ? 1 : sizeof(bytes));
+        if (result < 0) {
+            if (errno == EAGAIN) {
+                return value;
+            }
+
+            throw exception()
+                << boost::errinfo_errno(errno)
+                << boost::errinfo_api_function("read");
+        }
+
+        value += result;
+        if (semaphore_ || !result) {
+            return value;
+        }
+    }
+}
+
+#endif
+
+} // namespace reactor
+} // namespace meridian
@@ -0,0 +1,301 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__)
+
+#include "meridian/reactor/io_uring_reactor.hpp"
+#include "pipe_event_source.hpp"
+#include "timer_test.hpp"
+
+#include <memory>
+#include <vector>
+
+using meridian::reactor::io_uring_reactor;
+using meridian::reactor::event_type;
+
+BOOST_AUTO_TEST_SUITE(io_uring_reactor_tests)
+
+BOOST_AUTO_TEST_CASE(test_read_and_write_dispatch)
+{
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+
+    io_uring_reactor::scoped_registration<event_type::read> read_registration(
+            reactor, pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+    io_uring_reactor::scoped_registration<event_type::write> write_registration(
+            reactor, pipe.write_end, [&] { ++writes; });
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 0);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    write_registration.remove();
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_register_and_remove_on_same_fd)
+{
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+
+    reactor.register_read_callback(pipe.write_end, [&] { ++reads; });
+    reactor.register_write_callback(pipe.write_end, [&] { ++writes; });
+    reactor.remove_read_callback(pipe.write_end);
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 0);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_write_callback(pipe.write_end);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_callback_removing_other_source)
+{
+    io_uring_reactor reactor;
+    pipe_event_source first;
+    pipe_event_source second;
+    int calls = 0;
+
+    first.write_byte();
+    second.write_byte();
+
+    auto on_read = [&] {
+        ++calls;
+        if (first.read_end.has_callback()) reactor.remove_read_callback(first.read_end);
+        if (second.read_end.has_callback()) reactor.remove_read_callback(second.read_end);
+    };
+    reactor.register_read_callback(first.read_end, on_read);
+    reactor.register_read_callback(second.read_end, on_read);
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(calls, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_level_triggered_partial_read)
+{
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+
+    io_uring_reactor::scoped_registration<event_type::read> registration(
+            reactor, pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+
+    // A callback which leaves data behind must be called again without any new data arriving, just as with
+    // select_reactor.
+    pipe.write_byte();
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_edge_triggered_rearm)
+{
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+
+    reactor.set_trigger_mode(pipe.read_end, meridian::reactor::trigger_mode::edge);
+    io_uring_reactor::scoped_registration<event_type::read> registration(
+            reactor, pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+
+    pipe.write_byte();
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+
+    // The multishot request stays armed; new data produces another completion without re-submission.
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 2);
+
+    // One byte is still buffered, but there's been no new edge; re-arming asks for a fresh report.
+    reactor.rearm(pipe.read_end);
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fd_closed_and_reused_within_one_pass)
+{
+    io_uring_reactor reactor;
+    pipe_event_source first;
+    pipe_event_source second;
+    int reads = 0;
+
+    reactor.register_read_callback(first.read_end, [&] { ++reads; first.read_byte(); });
+    first.write_byte();
+    reactor.wait_for_events();
+    BOOST_REQUIRE_EQUAL(reads, 1);
+
+    // Another pass arms a fresh request, which holds a reference to the first pipe's file.
+    bool posted = false;
+    reactor.post([&] { posted = true; });
+    while (!posted) {
+        reactor.wait_for_events();
+    }
+
+    // Between flushes, the registration is removed, its descriptor closed, and the number reused for a new file
+    // registered with the same interest.
+    int const fd = first.read_end.fd();
+    reactor.remove_read_callback(first.read_end);
+    BOOST_REQUIRE(::dup2(second.read_end.fd(), fd) == fd);
+    ::close(second.read_end.fd());
+    second.read_end.reset_fd(fd);
+    first.read_end.reset_fd(-1);
+
+    reactor.register_read_callback(second.read_end, [&] { ++reads; second.read_byte(); });
+    second.write_byte();
+
+    // A request left on the first pipe would never complete; the timer bounds the wait.
+    bool timed_out = false;
+    reactor.schedule_after(std::chrono::milliseconds(100), [&] { timed_out = true; });
+    while (reads < 2 && !timed_out) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(reads, 2);
+
+    reactor.remove_read_callback(second.read_end);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fd_closed_while_registered)
+{
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int errors = 0;
+    int passes = 0;
+
+    // The descriptor is closed without the registration being removed, so the poll request fails with EBADF.
+    reactor.register_read_callback(pipe.read_end, [&] { ++errors; });
+    ::close(pipe.read_end.fd());
+
+    bool timed_out = false;
+    reactor.schedule_after(std::chrono::milliseconds(100), [&] { timed_out = true; });
+    while (!timed_out) {
+        reactor.wait_for_events();
+        ++passes;
+    }
+
+    // The error is reported once, and the failed request isn't re-armed, so the loop doesn't spin.
+    BOOST_CHECK_EQUAL(errors, 1);
+    BOOST_CHECK(passes < 10);
+
+    reactor.remove_read_callback(pipe.read_end);
+    pipe.read_end.reset_fd(-1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_many_registrations)
+{
+    io_uring_reactor reactor(8);
+    std::vector<std::unique_ptr<pipe_event_source>> pipes;
+    int writes = 0;
+
+    // More interest changes than submission queue entries in a single pass.
+    for (int i = 0; i < 32; ++i) {
+        pipes.emplace_back(new pipe_event_source);
+        reactor.register_write_callback(pipes.back()->write_end, [&] { ++writes; });
+    }
+
+    while (writes < 32) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(writes, 32);
+
+    for (auto & pipe : pipes) {
+        reactor.remove_write_callback(pipe->write_end);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_flush_with_full_completion_ring)
+{
+    io_uring_reactor reactor(4);
+    std::vector<std::unique_ptr<pipe_event_source>> pipes;
+    int writes = 0;
+
+    // Every poll completes as soon as it's armed, so the first few submissions fill the completion ring (twice the
+    // submission queue's 4 entries) and the rest of each flush has to be submitted while it's full. The callbacks leave
+    // the pipes writable, so every pass re-arms all of them.
+    for (int i = 0; i < 64; ++i) {
+        pipes.emplace_back(new pipe_event_source);
+        reactor.register_write_callback(pipes.back()->write_end, [&] { ++writes; });
+    }
+
+    while (writes < 3 * 64) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_GE(writes, 3 * 64);
+
+    for (auto & pipe : pipes) {
+        reactor.remove_write_callback(pipe->write_end);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_unified_handler)
+{
+    typedef meridian::core::event_source event_source;
+
+    io_uring_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+    event_source::event_mask read_ready = 0;
+    event_source::event_mask write_ready = 0;
+
+    reactor.register_handler(
+            pipe.read_end,
+            [&](event_source::event_mask ready) { ++reads; read_ready = ready; pipe.read_byte(); },
+            event_source::READABLE);
+    reactor.register_handler(
+            pipe.write_end,
+            [&](event_source::event_mask ready) { ++writes; write_ready = ready; },
+            event_source::WRITABLE);
+
+    pipe.write_byte();
+    while (!reads || !writes) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+    BOOST_CHECK(read_ready == event_source::READABLE);
+    BOOST_CHECK(write_ready == event_source::WRITABLE);
+
+    // With its interest set emptied, the write end stays registered but is no longer monitored.
+    reactor.set_interest(pipe.write_end, 0);
+    pipe.write_byte();
+    while (reads < 2) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(reads, 2);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_handler(pipe.read_end);
+    reactor.remove_handler(pipe.write_end);
+    BOOST_CHECK(!pipe.read_end.has_callback());
+    BOOST_CHECK(!pipe.write_end.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_timers)
+{
+    check_timers<io_uring_reactor>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* defined(__linux__) */
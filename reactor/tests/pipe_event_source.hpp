@@ -0,0 +1,40 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__tests__pipe_event_source__hpp
+#define meridian__reactor__tests__pipe_event_source__hpp
+
+#include "meridian/core/event_source.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//! \brief The two ends of a non-blocking pipe, each usable as an event_source in reactor tests.
+
+class pipe_event_source {
+public:
+    class end : public meridian::core::event_source {
+    public:
+        end() : event_source(-1) { }
+        ~end() { if (fd() >= 0) ::close(fd()); }
+
+        using event_source::reset_fd;
+    };
+
+    pipe_event_source() {
+        int fds[2];
+        if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+            read_end.reset_fd(fds[0]);
+            write_end.reset_fd(fds[1]);
+        }
+    }
+
+    void write_byte() { char c = 'x'; (void) ::write(write_end.fd(), &c, 1); }
+    ssize_t read_byte() { char c; return ::read(read_end.fd(), &c, 1); }
+
+    end read_end;
+    end write_end;
+};
+
+#endif /* meridian__reactor__tests__pipe_event_source__hpp */
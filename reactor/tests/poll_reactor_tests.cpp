@@ -0,0 +1,199 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/reactor/poll_reactor.hpp"
+#include "pipe_event_source.hpp"
+#include "timer_test.hpp"
+
+#include <sys/select.h>
+
+using meridian::reactor::poll_reactor;
+using meridian::reactor::event_type;
+
+BOOST_AUTO_TEST_SUITE(poll_reactor_tests)
+
+BOOST_AUTO_TEST_CASE(test_read_and_write_dispatch)
+{
+    poll_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+
+    poll_reactor::scoped_registration<event_type::read> read_registration(
+            reactor, pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+    poll_reactor::scoped_registration<event_type::write> write_registration(
+            reactor, pipe.write_end, [&] { ++writes; });
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 0);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    write_registration.remove();
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_register_and_remove_on_same_fd)
+{
+    poll_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+
+    reactor.register_read_callback(pipe.write_end, [&] { ++reads; });
+    reactor.register_write_callback(pipe.write_end, [&] { ++writes; });
+    reactor.remove_read_callback(pipe.write_end);
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 0);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_write_callback(pipe.write_end);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_callback_removing_other_source)
+{
+    poll_reactor reactor;
+    pipe_event_source first;
+    pipe_event_source second;
+    int calls = 0;
+
+    first.write_byte();
+    second.write_byte();
+
+    auto on_read = [&] {
+        ++calls;
+        if (first.read_end.has_callback()) reactor.remove_read_callback(first.read_end);
+        if (second.read_end.has_callback()) reactor.remove_read_callback(second.read_end);
+    };
+    reactor.register_read_callback(first.read_end, on_read);
+    reactor.register_read_callback(second.read_end, on_read);
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(calls, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_swap_remove)
+{
+    poll_reactor reactor;
+    pipe_event_source pipes[3];
+    int writes[3] = { };
+
+    for (int i = 0; i < 3; ++i) {
+        reactor.register_write_callback(pipes[i].write_end, [&writes, i] { ++writes[i]; });
+    }
+
+    // Removing the first entry moves the last into its slot; both remaining entries must still be monitored.
+    reactor.remove_write_callback(pipes[0].write_end);
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(writes[0], 0);
+    BOOST_CHECK_EQUAL(writes[1], 1);
+    BOOST_CHECK_EQUAL(writes[2], 1);
+
+    reactor.remove_write_callback(pipes[2].write_end);
+    reactor.remove_write_callback(pipes[1].write_end);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fd_beyond_fd_setsize)
+{
+    poll_reactor reactor;
+    pipe_event_source pipe;
+    pipe_event_source::end high;
+
+    int fd = ::fcntl(pipe.read_end.fd(), F_DUPFD_CLOEXEC, FD_SETSIZE + 16);
+    if (fd < 0) {
+        BOOST_TEST_MESSAGE("skipping; can't open a descriptor beyond FD_SETSIZE");
+        return;
+    }
+    high.reset_fd(fd);
+
+    int reads = 0;
+    poll_reactor::scoped_registration<event_type::read> registration(reactor, high, [&] { ++reads; pipe.read_byte(); });
+
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_fd_closed_while_registered)
+{
+    typedef meridian::core::event_source event_source;
+
+    poll_reactor reactor;
+    pipe_event_source first;
+    pipe_event_source second;
+    int errors = 0;
+    event_source::event_mask handled = 0;
+
+    // Both descriptors are closed without their registrations being removed, so poll() reports POLLNVAL for them.
+    reactor.register_read_callback(first.read_end, [&] { ++errors; reactor.remove_read_callback(first.read_end); });
+    reactor.register_handler(second.read_end, [&] (event_source::event_mask ready) {
+        handled = ready;
+        reactor.remove_handler(second.read_end);
+    }, event_source::READABLE);
+    ::close(first.read_end.fd());
+    ::close(second.read_end.fd());
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(errors, 1);
+    BOOST_CHECK_EQUAL(handled, event_source::READABLE);
+
+    first.read_end.reset_fd(-1);
+    second.read_end.reset_fd(-1);
+}
+
+BOOST_AUTO_TEST_CASE(test_unified_handler)
+{
+    typedef meridian::core::event_source event_source;
+
+    poll_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+    event_source::event_mask read_ready = 0;
+    event_source::event_mask write_ready = 0;
+
+    reactor.register_handler(
+            pipe.read_end,
+            [&](event_source::event_mask ready) { ++reads; read_ready = ready; pipe.read_byte(); },
+            event_source::READABLE);
+    reactor.register_handler(
+            pipe.write_end,
+            [&](event_source::event_mask ready) { ++writes; write_ready = ready; },
+            event_source::WRITABLE);
+
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+    BOOST_CHECK(read_ready == event_source::READABLE);
+    BOOST_CHECK(write_ready == event_source::WRITABLE);
+
+    // With its interest set emptied, the write end stays registered but is no longer monitored.
+    reactor.set_interest(pipe.write_end, 0);
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 2);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_handler(pipe.read_end);
+    reactor.remove_handler(pipe.write_end);
+    BOOST_CHECK(!pipe.read_end.has_callback());
+    BOOST_CHECK(!pipe.write_end.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_timers)
+{
+    check_timers<poll_reactor>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
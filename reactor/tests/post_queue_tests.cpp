@@ -0,0 +1,145 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/reactor/select_reactor.hpp"
+
+#include <thread>
+#include <vector>
+
+using meridian::reactor::post_queue;
+using meridian::reactor::select_reactor;
+
+BOOST_AUTO_TEST_SUITE(post_queue_tests)
+
+BOOST_AUTO_TEST_CASE(test_run_in_posted_order)
+{
+    post_queue queue;
+    std::vector<int> order;
+
+    BOOST_CHECK_EQUAL(queue.run(), 0u);
+
+    for (int i = 0; i < 5; ++i) {
+        queue.post([&order, i] { order.push_back(i); });
+    }
+
+    BOOST_CHECK_EQUAL(queue.run(), 5u);
+    BOOST_CHECK_EQUAL(queue.run(), 0u);
+    BOOST_REQUIRE_EQUAL(order.size(), 5u);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(order[i], i);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_post_from_callback_runs_in_next_batch)
+{
+    post_queue queue;
+    int first = 0;
+    int second = 0;
+
+    queue.post([&] { ++first; queue.post([&] { ++second; }); });
+
+    BOOST_CHECK_EQUAL(queue.run(), 1u);
+    BOOST_CHECK_EQUAL(first, 1);
+    BOOST_CHECK_EQUAL(second, 0);
+
+    BOOST_CHECK_EQUAL(queue.run(), 1u);
+    BOOST_CHECK_EQUAL(second, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_rest_of_batch_survives_throw)
+{
+    post_queue queue;
+    int calls = 0;
+
+    queue.post([] { throw 1; });
+    queue.post([&] { ++calls; });
+
+    BOOST_CHECK_THROW(queue.run(), int);
+    BOOST_CHECK_EQUAL(calls, 0);
+    BOOST_CHECK_EQUAL(queue.run(), 1u);
+    BOOST_CHECK_EQUAL(calls, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_unrun_callbacks_are_destroyed)
+{
+    auto counter = std::make_shared<int>(0);
+
+    {
+        post_queue queue;
+        queue.post([counter] { });
+        BOOST_CHECK_EQUAL(counter.use_count(), 2);
+    }
+
+    BOOST_CHECK_EQUAL(counter.use_count(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_posts_outlive_posting_thread)
+{
+    post_queue queue;
+    auto counter = std::make_shared<int>(0);
+
+    // The posting thread, and with it the free list its nodes go back to, is gone before they are run or destroyed.
+    for (int round = 0; round < 3; ++round) {
+        std::thread([&] {
+            for (int i = 0; i < 100; ++i) {
+                queue.post([counter] { ++*counter; });
+            }
+        }).join();
+    }
+
+    BOOST_CHECK_EQUAL(queue.run(), 300u);
+    BOOST_CHECK_EQUAL(*counter, 300);
+    BOOST_CHECK_EQUAL(counter.use_count(), 1);
+
+    std::thread([&] { queue.post([counter] { }); }).join();
+    BOOST_CHECK_EQUAL(counter.use_count(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_reactor_runs_posts_from_other_threads)
+{
+    static int const THREADS = 4;
+    static int const POSTS = 10000;
+
+    select_reactor reactor;
+    int last[THREADS];
+    bool in_order = true;
+    int received = 0;
+
+    for (int t = 0; t < THREADS; ++t) {
+        last[t] = -1;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < POSTS; ++i) {
+                reactor.post([&, t, i] {
+                    in_order = in_order && last[t] == i - 1;
+                    last[t] = i;
+                    ++received;
+                });
+            }
+        });
+    }
+
+    while (received < THREADS * POSTS) {
+        reactor.wait_for_events();
+    }
+
+    for (std::thread & thread : threads) {
+        thread.join();
+    }
+
+    BOOST_CHECK_EQUAL(received, THREADS * POSTS);
+    BOOST_CHECK(in_order);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
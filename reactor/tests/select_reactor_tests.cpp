@@ -0,0 +1,204 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/core/dense_event_source_registry.hpp"
+#include "meridian/reactor/exception.hpp"
+#include "meridian/reactor/select_reactor.hpp"
+#include "pipe_event_source.hpp"
+#include "timer_test.hpp"
+
+#include <pthread.h>
+#include <signal.h>
+#include <thread>
+
+using meridian::reactor::select_reactor;
+using meridian::reactor::event_type;
+
+namespace {
+
+//! \brief Moves a pipe end to a descriptor at or above \a minimum_fd.
+bool move_fd(pipe_event_source::end & end, int minimum_fd)
+{
+    int fd = ::fcntl(end.fd(), F_DUPFD_CLOEXEC, minimum_fd);
+    if (fd < 0) {
+        return false;
+    }
+
+    ::close(end.fd());
+    end.reset_fd(fd);
+    return true;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(select_reactor_tests)
+
+BOOST_AUTO_TEST_CASE(test_dispatch_across_words)
+{
+    select_reactor reactor;
+    pipe_event_source low;
+    pipe_event_source high;
+    BOOST_REQUIRE(move_fd(high.read_end, 200));
+
+    int low_reads = 0;
+    int high_reads = 0;
+
+    select_reactor::scoped_registration<event_type::read> low_registration(
+            reactor, low.read_end, [&] { ++low_reads; low.read_byte(); });
+    select_reactor::scoped_registration<event_type::read> high_registration(
+            reactor, high.read_end, [&] { ++high_reads; high.read_byte(); });
+
+    low.write_byte();
+    high.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(low_reads, 1);
+    BOOST_CHECK_EQUAL(high_reads, 1);
+
+    // Removing the highest fd must not lose the lower one.
+    high_registration.remove();
+    low.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(low_reads, 2);
+    BOOST_CHECK_EQUAL(high_reads, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_dense_registry)
+{
+    select_reactor reactor(std::unique_ptr<meridian::core::abstract_event_source_registry>(
+            new meridian::core::dense_event_source_registry(4)));
+    pipe_event_source pipe;
+    BOOST_REQUIRE(move_fd(pipe.read_end, 100));
+
+    int reads = 0;
+    select_reactor::scoped_registration<event_type::read> registration(
+            reactor, pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_write_and_except_removal)
+{
+    select_reactor reactor;
+    pipe_event_source pipe;
+    int writes = 0;
+    int reads = 0;
+
+    reactor.register_write_callback(pipe.write_end, [&] { ++writes; });
+    reactor.register_except_callback(pipe.write_end, [] { });
+    reactor.register_read_callback(pipe.read_end, [&] { ++reads; pipe.read_byte(); });
+
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_write_callback(pipe.write_end);
+    reactor.remove_except_callback(pipe.write_end);
+    BOOST_CHECK(!pipe.write_end.has_callback());
+
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(writes, 1);
+    BOOST_CHECK_EQUAL(reads, 1);
+
+    reactor.remove_read_callback(pipe.read_end);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fd_beyond_fd_setsize_is_rejected)
+{
+    select_reactor reactor;
+    pipe_event_source pipe;
+
+    if (!move_fd(pipe.read_end, FD_SETSIZE)) {
+        BOOST_TEST_MESSAGE("skipping; can't open a descriptor beyond FD_SETSIZE");
+        return;
+    }
+
+    BOOST_CHECK_THROW(reactor.register_read_callback(pipe.read_end, [] { }),
+                      meridian::reactor::unsupported_operation_exception);
+    BOOST_CHECK(!pipe.read_end.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_unified_handler)
+{
+    typedef meridian::core::event_source event_source;
+
+    select_reactor reactor;
+    pipe_event_source pipe;
+    int reads = 0;
+    int writes = 0;
+    event_source::event_mask read_ready = 0;
+    event_source::event_mask write_ready = 0;
+
+    reactor.register_handler(
+            pipe.read_end,
+            [&](event_source::event_mask ready) { ++reads; read_ready = ready; pipe.read_byte(); },
+            event_source::READABLE);
+    reactor.register_handler(
+            pipe.write_end,
+            [&](event_source::event_mask ready) { ++writes; write_ready = ready; },
+            event_source::WRITABLE);
+
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 1);
+    BOOST_CHECK_EQUAL(writes, 1);
+    BOOST_CHECK(read_ready == event_source::READABLE);
+    BOOST_CHECK(write_ready == event_source::WRITABLE);
+
+    // With its interest set emptied, the write end stays registered but is no longer monitored.
+    reactor.set_interest(pipe.write_end, 0);
+    pipe.write_byte();
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(reads, 2);
+    BOOST_CHECK_EQUAL(writes, 1);
+
+    reactor.remove_handler(pipe.read_end);
+    reactor.remove_handler(pipe.write_end);
+    BOOST_CHECK(!pipe.read_end.has_callback());
+    BOOST_CHECK(!pipe.write_end.has_callback());
+}
+
+BOOST_AUTO_TEST_CASE(test_timers)
+{
+    check_timers<select_reactor>();
+}
+
+BOOST_AUTO_TEST_CASE(test_signal_interrupts_wait)
+{
+    select_reactor reactor;
+    bool fired = false;
+    reactor.schedule_after(std::chrono::seconds(1), [&] { fired = true; });
+
+    struct sigaction action = {};
+    struct sigaction previous;
+    action.sa_handler = [] (int) { };
+    BOOST_REQUIRE(::sigaction(SIGUSR1, &action, &previous) == 0);
+
+    // A signal_source elsewhere may have left SIGUSR1 blocked.
+    sigset_t unblocked;
+    sigset_t previous_mask;
+    ::sigemptyset(&unblocked);
+    ::sigaddset(&unblocked, SIGUSR1);
+    BOOST_REQUIRE(::pthread_sigmask(SIG_UNBLOCK, &unblocked, &previous_mask) == 0);
+
+    // The signal interrupts select(), which is a spurious wakeup, not an error.
+    pthread_t const waiting = ::pthread_self();
+    std::thread signaller([waiting] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ::pthread_kill(waiting, SIGUSR1);
+    });
+    BOOST_CHECK_NO_THROW(reactor.wait_for_events());
+    signaller.join();
+    BOOST_CHECK(!fired);
+
+    ::pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr);
+    ::sigaction(SIGUSR1, &previous, nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
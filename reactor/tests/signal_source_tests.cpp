@@ -0,0 +1,53 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__)
+
+#include "meridian/reactor/epoll_reactor.hpp"
+#include "meridian/reactor/signal_source.hpp"
+
+#include <pthread.h>
+
+using meridian::reactor::epoll_reactor;
+using meridian::reactor::event_type;
+using meridian::reactor::signal_source;
+
+BOOST_AUTO_TEST_SUITE(signal_source_tests)
+
+BOOST_AUTO_TEST_CASE(test_signal_is_delivered_as_readable_event)
+{
+    // The signal_source leaves SIGUSR1 blocked, which would keep it from interrupting later tests.
+    sigset_t previous;
+    BOOST_REQUIRE(::pthread_sigmask(SIG_SETMASK, nullptr, &previous) == 0);
+
+    epoll_reactor reactor;
+    signal_source signals { SIGUSR1 };
+    int received = 0;
+
+    epoll_reactor::scoped_registration<event_type::read> registration(
+            reactor, signals, [&] {
+                signalfd_siginfo info;
+                while (signals.read_signal(info)) {
+                    received = info.ssi_signo;
+                }
+            });
+
+    ::raise(SIGUSR1);
+    auto const deadline = epoll_reactor::clock::now() + std::chrono::seconds(5);
+    while (!received && epoll_reactor::clock::now() < deadline) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(received, SIGUSR1);
+
+    signalfd_siginfo info;
+    BOOST_CHECK(!signals.read_signal(info));
+
+    ::pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* defined(__linux__) */
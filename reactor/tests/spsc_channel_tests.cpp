@@ -0,0 +1,74 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/reactor/spsc_channel.hpp"
+
+#include <thread>
+
+using meridian::reactor::spsc_channel;
+
+BOOST_AUTO_TEST_SUITE(spsc_channel_tests)
+
+BOOST_AUTO_TEST_CASE(test_capacity_rounds_up)
+{
+    BOOST_CHECK_EQUAL(spsc_channel<int>(1).capacity(), 1u);
+    BOOST_CHECK_EQUAL(spsc_channel<int>(5).capacity(), 8u);
+    BOOST_CHECK_EQUAL(spsc_channel<int>(64).capacity(), 64u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_push_until_full_then_pop_in_order)
+{
+    spsc_channel<std::unique_ptr<int>> channel(4);
+
+    for (int i = 0; i < 4; ++i) {
+        BOOST_CHECK(channel.try_push(std::unique_ptr<int>(new int(i))));
+    }
+
+    std::unique_ptr<int> rejected(new int(4));
+    BOOST_CHECK(!channel.try_push(std::move(rejected)));
+    BOOST_CHECK(rejected);
+
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 4; ++i) {
+        BOOST_REQUIRE(channel.try_pop(value));
+        BOOST_CHECK_EQUAL(*value, i);
+    }
+    BOOST_CHECK(!channel.try_pop(value));
+
+    // Leave a value behind for the destructor.
+    BOOST_CHECK(channel.try_push(std::move(rejected)));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_two_threads)
+{
+    static size_t const COUNT = 100000;
+
+    spsc_channel<size_t> channel(64);
+    std::thread producer([&] {
+        for (size_t i = 0; i < COUNT; ++i) {
+            size_t value = i;
+            while (!channel.try_push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool in_order = true;
+    for (size_t expected = 0; expected < COUNT; ) {
+        size_t value;
+        if (channel.try_pop(value)) {
+            in_order = in_order && value == expected;
+            ++expected;
+        }
+    }
+
+    producer.join();
+    BOOST_CHECK(in_order);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__)
+
+#include "meridian/reactor/epoll_reactor.hpp"
+#include "meridian/reactor/timer_source.hpp"
+
+using meridian::reactor::epoll_reactor;
+using meridian::reactor::event_type;
+using meridian::reactor::timer_source;
+
+BOOST_AUTO_TEST_SUITE(timer_source_tests)
+
+BOOST_AUTO_TEST_CASE(test_disarmed_timer_has_no_expirations)
+{
+    timer_source timer;
+    BOOST_CHECK(timer.fd() >= 0);
+    BOOST_CHECK_EQUAL(timer.read_expirations(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_relative_timer)
+{
+    epoll_reactor reactor;
+    timer_source timer;
+    uint64_t expirations = 0;
+
+    epoll_reactor::scoped_registration<event_type::read> registration(
+            reactor, timer, [&] { expirations += timer.read_expirations(); });
+
+    timer.set_after(std::chrono::milliseconds(1));
+
+    // A single pass may end early (e.g., on EINTR) without the timer having fired.
+    auto const deadline = epoll_reactor::clock::now() + std::chrono::seconds(5);
+    while (!expirations && epoll_reactor::clock::now() < deadline) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(expirations, 1u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_absolute_timer_in_the_past_expires)
+{
+    epoll_reactor reactor;
+    timer_source timer;
+    uint64_t expirations = 0;
+
+    epoll_reactor::scoped_registration<event_type::read> registration(
+            reactor, timer, [&] { expirations += timer.read_expirations(); });
+
+    timer.set_at(timer_source::clock::now() - std::chrono::seconds(1));
+
+    // A single pass may end early (e.g., on EINTR) without the timer having fired.
+    auto const deadline = epoll_reactor::clock::now() + std::chrono::seconds(5);
+    while (!expirations && epoll_reactor::clock::now() < deadline) {
+        reactor.wait_for_events();
+    }
+    BOOST_CHECK_EQUAL(expirations, 1u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_interval_timer)
+{
+    epoll_reactor reactor;
+    timer_source timer;
+    uint64_t expirations = 0;
+
+    epoll_reactor::scoped_registration<event_type::read> registration(
+            reactor, timer, [&] { expirations += timer.read_expirations(); });
+
+    timer.set_after(std::chrono::milliseconds(1), std::chrono::milliseconds(1));
+    while (expirations < 3) {
+        reactor.wait_for_events();
+    }
+
+    timer.disarm();
+    timer.read_expirations();
+    BOOST_CHECK_EQUAL(timer.read_expirations(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* defined(__linux__) */
@@ -0,0 +1,36 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef meridian__reactor__tests__timer_test__hpp
+#define meridian__reactor__tests__timer_test__hpp
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+//! \brief Checks that \a REACTOR calls a timer, and not a cancelled one, from wait_for_events() by its deadline.
+//!
+//! Each reactor registers its post_queue's wakeup source when it's constructed, so its wait isn't over an empty set;
+//! but nothing is posted or ready, so only the timer's deadline can end the wait.
+
+template <typename REACTOR>
+void check_timers()
+{
+    REACTOR reactor;
+    int fired = 0;
+
+    typename REACTOR::timer_id cancelled = reactor.schedule_after(std::chrono::milliseconds(1), [&] { fired += 100; });
+    reactor.schedule_after(std::chrono::milliseconds(2), [&] { ++fired; });
+    BOOST_CHECK(reactor.cancel(cancelled));
+
+    auto const begin = REACTOR::clock::now();
+    while (!fired) {
+        reactor.wait_for_events();
+    }
+
+    BOOST_CHECK_EQUAL(fired, 1);
+    BOOST_CHECK(REACTOR::clock::now() - begin < std::chrono::seconds(1));
+}
+
+#endif /* meridian__reactor__tests__timer_test__hpp */
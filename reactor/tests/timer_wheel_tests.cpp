@@ -0,0 +1,134 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#include "meridian/reactor/timer_wheel.hpp"
+
+#include <random>
+#include <vector>
+
+using meridian::reactor::timer_wheel;
+using std::chrono::milliseconds;
+using std::chrono::hours;
+
+namespace {
+
+timer_wheel::clock::time_point const start{ hours(1) };
+
+}
+
+BOOST_AUTO_TEST_SUITE(timer_wheel_tests)
+
+BOOST_AUTO_TEST_CASE(test_expiry_and_timeout)
+{
+    timer_wheel wheel(start);
+    std::vector<int> fired;
+
+    wheel.schedule_at(start + milliseconds(10), [&] { fired.push_back(10); });
+    wheel.schedule_at(start + milliseconds(300), [&] { fired.push_back(300); });
+    wheel.schedule_at(start + hours(24 * 10), [&] { fired.push_back(-1); });
+    BOOST_CHECK_EQUAL(wheel.size(), 3u);
+
+    BOOST_CHECK_EQUAL(wheel.timeout(start, 5000), 10);
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(9)), 0u);
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(10)), 1u);
+
+    // 300ms is on a higher level; the wait ends at the start of its slot, which is never after the deadline.
+    int const timeout = wheel.timeout(start + milliseconds(10), 5000);
+    BOOST_CHECK_GT(timeout, 0);
+    BOOST_CHECK_LE(timeout, 290);
+
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(299)), 0u);
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(1000)), 1u);
+    BOOST_CHECK_EQUAL(wheel.timeout(start + milliseconds(1000), 5000), 5000);
+
+    BOOST_REQUIRE_EQUAL(fired.size(), 2u);
+    BOOST_CHECK_EQUAL(fired[0], 10);
+    BOOST_CHECK_EQUAL(fired[1], 300);
+    BOOST_CHECK_EQUAL(wheel.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_cancel)
+{
+    timer_wheel wheel(start);
+    int fired = 0;
+
+    timer_wheel::timer_id first = wheel.schedule_at(start + milliseconds(5), [&] { ++fired; });
+    timer_wheel::timer_id second = wheel.schedule_at(start + milliseconds(5000), [&] { ++fired; });
+
+    BOOST_CHECK(wheel.cancel(second));
+    BOOST_CHECK(!wheel.cancel(second));
+    BOOST_CHECK_EQUAL(wheel.timeout(start, 60000), 5);
+
+    // The freed node is reused, but the old identifier stays dead.
+    timer_wheel::timer_id third = wheel.schedule_at(start + milliseconds(7), [&] { ++fired; });
+    BOOST_CHECK(third != second);
+    BOOST_CHECK(!wheel.cancel(second));
+
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(10000)), 2u);
+    BOOST_CHECK_EQUAL(fired, 2);
+    BOOST_CHECK(!wheel.cancel(first));
+    BOOST_CHECK_EQUAL(wheel.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_callbacks_schedule_and_cancel)
+{
+    timer_wheel wheel(start);
+    int fired = 0;
+    timer_wheel::timer_id victim = 0;
+
+    wheel.schedule_at(start + milliseconds(1), [&] {
+        ++fired;
+        wheel.cancel(victim);
+        wheel.schedule_at(start, [&] { ++fired; });
+    });
+    victim = wheel.schedule_at(start + milliseconds(1), [&] { fired += 100; });
+
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(1)), 1u);
+    BOOST_CHECK_EQUAL(fired, 1);
+
+    // The timer scheduled in the past by the callback waits for the next expire().
+    BOOST_CHECK_EQUAL(wheel.timeout(start + milliseconds(1), 5000), 0);
+    BOOST_CHECK_EQUAL(wheel.expire(start + milliseconds(1)), 1u);
+    BOOST_CHECK_EQUAL(fired, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_matches_brute_force)
+{
+    timer_wheel wheel(start);
+    std::mt19937_64 random(42);
+    std::vector<long> deadlines;
+    std::vector<long> fired_at;
+    long now = 0;
+
+    for (int i = 0; i < 2000; ++i) {
+        long const deadline = random() % (1 << (random() % 24));
+        deadlines.push_back(deadline);
+        fired_at.push_back(-1);
+        wheel.schedule_at(start + milliseconds(deadline), [&fired_at, &now, i] { fired_at[i] = now; });
+    }
+
+    while (wheel.size()) {
+        int const timeout = wheel.timeout(start + milliseconds(now), 1 << 30);
+
+        // Never sleep past a deadline.
+        long next = -1;
+        for (size_t i = 0; i < deadlines.size(); ++i) {
+            if (fired_at[i] < 0 && (next < 0 || deadlines[i] < next)) {
+                next = deadlines[i];
+            }
+        }
+        BOOST_REQUIRE_LE(now + timeout, std::max(now, next));
+
+        now += timeout ? 1 + random() % timeout : 0;
+        wheel.expire(start + milliseconds(now));
+    }
+
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        BOOST_REQUIRE_GE(fired_at[i], deadlines[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,49 @@
+// Copyright Eric Crampton, 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__)
+
+#include "meridian/reactor/epoll_reactor.hpp"
+#include "meridian/reactor/wakeup_source.hpp"
+
+using meridian::reactor::epoll_reactor;
+using meridian::reactor::event_type;
+using meridian::reactor::wakeup_source;
+
+BOOST_AUTO_TEST_SUITE(wakeup_source_tests)
+
+BOOST_AUTO_TEST_CASE(test_notifications_are_coalesced)
+{
+    epoll_reactor reactor;
+    wakeup_source wakeup;
+    int calls = 0;
+    uint64_t total = 0;
+
+    epoll_reactor::scoped_registration<event_type::read> registration(
+            reactor, wakeup, [&] { ++calls; total += wakeup.consume(); });
+
+    wakeup.notify();
+    wakeup.notify(2);
+    reactor.wait_for_events();
+    BOOST_CHECK_EQUAL(calls, 1);
+    BOOST_CHECK_EQUAL(total, 3u);
+    BOOST_CHECK_EQUAL(wakeup.consume(), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_semaphore_mode)
+{
+    wakeup_source wakeup(true);
+
+    wakeup.notify(2);
+    BOOST_CHECK_EQUAL(wakeup.consume(), 1u);
+    BOOST_CHECK_EQUAL(wakeup.consume(), 1u);
+    BOOST_CHECK_EQUAL(wakeup.consume(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* defined(__linux__) */